@@ -109,6 +109,10 @@
 # define PORTA_REG 0x02		/* port A */
 #endif
 
+/* port pairs for D16 access (low byte = port A/C, high byte = port B/D) */
+#define PORTCD_REG 0x00		/* port C/D */
+#define PORTAB_REG 0x02		/* port A/B */
+
 #define CTRL0_REG 0x80		/* control 0 */
 #define CTRL1_REG 0x82		/* control 1 */
 #define CTRL2_REG 0x84		/* control 2 */
@@ -128,8 +132,21 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
-/* ll handle */
+typedef struct LL_HANDLE LL_HANDLE;	/* ll handle (see below) */
+
+/* include files which need LL_HANDLE */
+#include <MEN/ll_entry.h>   /* low level driver jumptable  */
+#include <MEN/m58_drv.h>   /* M58 driver header file */
+
+/* channel plan entry (one bus cycle) */
 typedef struct {
+	u_int8			reg;			/* register offset */
+	u_int8			d16;			/* D16 access of port pair */
+	u_int8			shift;			/* bit position in input image */
+} PLAN_ENTRY;
+
+/* ll handle */
+struct LL_HANDLE {
 	/* general */
 	int32			memAlloc;		/* size allocated for the handle */
 	OSS_HANDLE		*osHdl;			/* oss handle */
@@ -138,27 +155,150 @@ typedef struct {
 	MACCESS			ma;				/* hw access handle */
 	MDIS_IDENT_FUNCT_TBL idFuncTbl;	/* id function table */
 	OSS_SIG_HANDLE	*sigHdl;		/* signal handle */
+	OSS_SEM_HANDLE	*devSemHdl;		/* device semaphore handle */
+	/* signal coalescing */
+	u_int32			sigEvery;		/* signal every n triggers (0,1=all) */
+	u_int32			sigMinTime;		/* min. signal interval [usec] */
+	u_int32			sigMinTicks;	/* min. signal interval [ticks] */
+	u_int32			sigFill;		/* input buffer fill threshold [bytes] */
+	u_int32			sigArmed;		/* fill threshold armed */
+	u_int32			sigPend;		/* triggers since last signal */
+	u_int32			sigLast;		/* tick of last signal */
+	/* wait for triggers */
+	OSS_SEM_HANDLE	*waitSem;		/* trigger wait semaphore */
+	u_int32			waitActive;		/* caller waiting */
+	u_int32			waitLeft;		/* triggers left to wait for */
+	u_int32			waitFill;		/* input buffer fill level to wait for */
 	/* debug */
 	u_int32			dbgLevel;		/* debug level */
 	DBG_HANDLE		*dbgHdl;		/* debug handle */
 	/* misc */
 	u_int32			idCheck;		/* id check enabled */
+	u_int32			idCache;		/* id prom cache enabled */
+	u_int32			idValid;		/* idData is valid */
+	u_int16			idData[MOD_ID_SIZE/2];	/* id prom cache */
 	u_int32			irqCount;		/* interrupt counter */
 	u_int32			portDir[CH_NUMBER];		/* port direction */
 	u_int32			portTerm[CH_NUMBER];	/* port termination */
 	u_int8			portReg[CH_NUMBER];		/* port registers */
 	u_int32			trigEdge;		/* trigger edge */
 	u_int32			dataMode;		/* data storage mode */
+	u_int16			ctrl0;			/* CTRL0 shadow (port dir) */
+	u_int16			ctrl1;			/* CTRL1 shadow (port term) */
+	u_int16			ctrl2;			/* CTRL2 shadow (trig edge/data mode) */
+	u_int16			ctrl3;			/* CTRL3 shadow (irq enable) */
+	u_int32			outImage;		/* output shadow (port A..D = bit 0..31) */
 	/* buffers */
 	u_int32			bufEnable[CH_NUMBER];	/* buffer this channel */
 	int32			bufRdSize;		/* nr of enabled input  channels */
 	int32			bufWrSize;		/* nr of enabled output channel */
+	PLAN_ENTRY		rdPlan[CH_NUMBER];		/* read  plan of input  channels */
+	PLAN_ENTRY		wrPlan[CH_NUMBER];		/* write plan of output channels */
+	int32			rdCycles;		/* nr of read  plan entries */
+	int32			wrCycles;		/* nr of write plan entries */
+	u_int32			rdSamples;		/* direct input frames per block read */
+	u_int32			rdPace;			/* direct input sample period [usec] */
+	u_int32			rdBits;			/* input image bits of read plan */
+	u_int32			cmdDelay;		/* OSS_MikroDelayInit done for CmdList */
+	/* debounce filter */
+	u_int32			dbCount[CH_NUMBER];	/* stable count (0,1 = off) */
+	u_int32			dbChMask[CH_NUMBER];/* filtered bits of channel */
+	u_int32			dbMask;			/* filtered bits of input image */
+	u_int32			dbValid;		/* bits with valid stable state */
+	u_int32			dbState;		/* stable (filtered) input image */
+	u_int32			dbPend;			/* bits currently counting */
+	u_int8			dbCnt[CH_NUMBER*8];	/* per-bit integrator */
+	/* pulse counters */
+	u_int32			cntRise;		/* bits counting rising  edges */
+	u_int32			cntFall;		/* bits counting falling edges */
+	u_int32			cntLast;		/* input image of previous trigger */
+	u_int32			cntValid;		/* cntLast is valid */
+	u_int32			cnt[CH_NUMBER*8];	/* per-bit edge counters */
+	/* periodic sampling */
+	OSS_ALARM_HANDLE *alarmHdl;		/* sample alarm handle */
+	u_int32			smpPeriod;		/* sample period [msec] (0=off) */
+	u_int32			smpTicks;		/* sample period [ticks] */
+	u_int32			smpLast;		/* tick of previous sample */
+	u_int32			smpValid;		/* smpLast is valid */
+	u_int32			smpMissed;		/* missed sample periods */
+	/* interrupt moderation */
+	OSS_ALARM_HANDLE *modAlarmHdl;	/* moderation alarm handle */
+	u_int32			irqEnable;		/* irq enabled (M_MK_IRQ_ENABLE) */
+	u_int32			modThresh;		/* max. triggers per poll period (0=off) */
+	u_int32			modPeriod;		/* poll period [msec] */
+	u_int32			modHold;		/* poll periods before irq re-arm */
+	u_int32			modCount;		/* triggers in current poll period */
+	u_int32			modLeft;		/* poll periods left (0=irq mode) */
+	u_int32			modActive;		/* moderation alarm running */
+	/* output playback */
+	u_int32			pbMode;			/* playback mode (M58_PB_xxx) */
+	u_int32			pbPace;			/* timed playback period [usec] */
+	u_int32			pbTout;			/* triggered playback timeout [msec] */
+	u_int8			*pbBufP;		/* next frame to emit by M58_Irq */
+	volatile int32	pbLeft;			/* nr of frames left for M58_Irq */
+	OSS_SEM_HANDLE	*pbSem;			/* playback done semaphore */
 	MBUF_HANDLE		*bufHdl;		/* input buffer handle */
-} LL_HANDLE;
-
-/* include files which need LL_HANDLE */
-#include <MEN/ll_entry.h>   /* low level driver jumptable  */
-#include <MEN/m58_drv.h>   /* M58 driver header file */
+	MBUF_HANDLE		*wrBufHdl;		/* output buffer handle */
+	u_int32			wrDrain;		/* output buffer in ring mode */
+	u_int32			inBufSize;		/* input buffer size [bytes] */
+	u_int32			tsEnable;		/* timestamped input records */
+	u_int32			tsSeq;			/* trigger sequence number */
+	int32			recSize;		/* input buffer record size [bytes] */
+	u_int32			recTs;			/* records are M58_TS_REC */
+	u_int32			captMode;		/* capture mode (M58_CAPT_xxx) */
+	u_int32			captMask;		/* change detection mask */
+	u_int32			captLast;		/* input image of last stored record */
+	u_int32			captValid;		/* captLast is valid */
+	/* edge events */
+	MBUF_HANDLE		*evtBufHdl;		/* event buffer handle */
+	u_int32			evtMask;		/* input bits generating events */
+	u_int32			evtLast;		/* input image of previous trigger */
+	u_int32			evtValid;		/* evtLast is valid */
+	u_int32			evtLost;		/* events lost (buffer overrun) */
+	u_int32			rdSource;		/* block read source (M58_SRC_xxx) */
+	/* capture window */
+	u_int8			*winBuf;		/* history (winDepth records) */
+	u_int32			winAlloc;		/* allocated history size [bytes] */
+	u_int32			winDepth;		/* history size [records] */
+	u_int32			winPre;			/* pre-trigger records */
+	u_int32			winPost;		/* post-trigger records (incl. trigger) */
+	u_int32			winMask;		/* arm condition mask (0=unconditional) */
+	u_int32			winValue;		/* arm condition value */
+	u_int32			winState;		/* window state (M58_WIN_xxx) */
+	u_int32			winMatch;		/* previous sample matched */
+	u_int32			winIdx;			/* next history slot */
+	u_int32			winCount;		/* records of current capture */
+	u_int32			winLeft;		/* post-trigger records left */
+	/* pattern match */
+	u_int32			matMode;		/* match actions (M58_MATCH_xxx, 0=off) */
+	u_int32			matCount;		/* nr of table entries */
+	u_int32			matBits;		/* input bits of all table masks */
+	u_int32			matMask[M58_MATCH_MAX];	/* table: input bits to compare */
+	u_int32			matValue[M58_MATCH_MAX];	/* table: expected values */
+	u_int32			matLast;		/* previous sample matched */
+	u_int32			matHit;			/* current sample is a hit */
+	u_int32			matHits;		/* hits counter */
+	/* reflex rules */
+	u_int32			rflCount;		/* nr of rules (0=off) */
+	u_int32			rflBits;		/* channel bits of all conditions */
+	u_int32			rflMask[M58_RFL_MAX];	/* condition: input bits */
+	u_int32			rflValue[M58_RFL_MAX];	/* condition: expected values */
+	u_int8			rflPort[M58_RFL_MAX];	/* output channel */
+	u_int8			rflAction[M58_RFL_MAX];	/* action (M58_RFL_xxx) */
+	u_int8			rflData[M58_RFL_MAX];	/* action bits/value */
+	u_int32			rflLast;		/* rules matched on previous sample */
+	u_int32			rflHits[M58_RFL_MAX];	/* rule hit counters */
+	/* statistics (see M58_STATS) */
+	u_int32			statTrig;		/* triggers seen */
+	u_int32			statStored;		/* records stored */
+	u_int32			statDropped;	/* records dropped */
+	u_int32			statPartial;	/* records stored incompletely */
+	u_int32			statSigSent;	/* trigger signals sent */
+	u_int32			statFillMax;	/* max. input buffer fill level */
+	u_int32			statModPoll;	/* switches to polled mode */
+	u_int32			statBusD8;		/* port D8 cycles issued */
+	u_int32			statBusD16;		/* port D16 cycles issued */
+};
 
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
@@ -168,6 +308,44 @@ static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 static char* Ident( void );
 static int32 Cleanup(LL_HANDLE *llHdl, int32 retCode);
 static u_int32 CalcBufSize(LL_HANDLE *llHdl, u_int32 portDir);
+static u_int32 ReadFrame(LL_HANDLE *llHdl, u_int8 *bufP);
+static void WriteFrame(LL_HANDLE *llHdl, u_int8 *bufP);
+static u_int8* ReadPlanEntry(LL_HANDLE *llHdl, PLAN_ENTRY *planP,
+							 u_int8 *bufP, u_int32 *inP);
+static u_int8* WritePlanEntry(LL_HANDLE *llHdl, PLAN_ENTRY *planP,
+							  u_int8 *bufP);
+static u_int32 FillRecord(LL_HANDLE *llHdl, u_int8 *recP, u_int32 tick);
+static int32 StoreRecord(LL_HANDLE *llHdl, u_int8 *recP);
+static int32 PutRecord(LL_HANDLE *llHdl, MBUF_HANDLE *bufHdl, u_int8 *recP,
+					   int32 size);
+static void FlushInBuf(LL_HANDLE *llHdl);
+static void StoreEvents(LL_HANDLE *llHdl, u_int32 in, u_int32 tick);
+static void CountEdges(LL_HANDLE *llHdl, u_int32 in);
+static void Sample(LL_HANDLE *llHdl, u_int32 tick);
+static void SampleAlarm(void *arg);
+static int32 SetSamplePeriod(LL_HANDLE *llHdl, u_int32 msec);
+static void ModAlarm(void *arg);
+static int32 SetModeration(LL_HANDLE *llHdl);
+static u_int32 Ctz32(u_int32 x);
+static void CalcDebounce(LL_HANDLE *llHdl);
+static u_int32 Debounce(LL_HANDLE *llHdl, u_int32 in, u_int32 bits);
+static void WriteSplitFrame(LL_HANDLE *llHdl, u_int8 *bufP, int32 got);
+static int32 SigDue(LL_HANDLE *llHdl, u_int32 tick);
+static int32 WaitTrig(LL_HANDLE *llHdl, M58_WAIT *waitP);
+static void WindowStore(LL_HANDLE *llHdl, u_int8 *recP, u_int32 in);
+static u_int32 MatchTable(LL_HANDLE *llHdl, u_int32 in);
+static void WritePort(LL_HANDLE *llHdl, int32 ch, u_int8 value);
+static void Reflex(LL_HANDLE *llHdl, u_int32 in);
+static u_int32 OutBits(LL_HANDLE *llHdl);
+static void WriteOutputs(LL_HANDLE *llHdl, u_int32 image);
+static u_int32 ChanBits(u_int32 bits);
+static u_int32 ReadPorts(LL_HANDLE *llHdl, u_int32 bits);
+static u_int32 ReadInputs(LL_HANDLE *llHdl);
+static void ReadIdProm(LL_HANDLE *llHdl);
+static int32 CmdList(LL_HANDLE *llHdl, M58_CMD *cmdP, u_int32 count,
+					 u_int32 *doneP);
+static int32 WindowRead(LL_HANDLE *llHdl, u_int8 *bufP, int32 size,
+						int32 *nbrRdBytesP);
 
 static int32 M58_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
 					   MACCESS *ma, OSS_SEM_HANDLE *devSemHdl,
@@ -228,15 +406,46 @@ static int32 M58_Info(int32     infoType, ... );
  *                DEBUG_LEVEL_MBUF      OSS_DBG_DEFAULT  see dbg.h
  *                DEBUG_LEVEL           OSS_DBG_DEFAULT  see dbg.h
  *                ID_CHECK              1                0..1
+ *                ID_CACHE              1                0..1
  *                TRIG_EDGE				0                0..1
  *                DATA_MODE				0                0..7
  *                CHANNEL_n/PORT_DIR	1                0..1
  *                CHANNEL_n/PORT_TERM	1                0..1
  *                CHANNEL_n/BUF_ENABLE	1                0..1
+ *                CHANNEL_n/DEBOUNCE	0                0..255
+ *                CHANNEL_n/DEBOUNCE_MASK 0xff           0..0xff
  *                IN_BUF/SIZE           8                0..max
  *                IN_BUF/MODE           0                M_BUF_xxx
  *                IN_BUF/TIMEOUT        0                0..max
  *                IN_BUF/HIGHWATER      0                0..max
+ *                IN_BUF/TIMESTAMP      0                0..1
+ *                IN_BUF/CAPTURE        0                0..1
+ *                IN_BUF/CHANGE_MASK    0xffffffff       0..0xffffffff
+ *                IN_BUF/PERIOD         0                0..max
+ *                WINDOW/PRE            0                0..max
+ *                WINDOW/POST           0                0..max
+ *                MATCH/MODE            0                0..7
+ *                MATCH/MASK_n          -                0..0xffffffff
+ *                MATCH/VALUE_n         0                0..0xffffffff
+ *                EVT_BUF/SIZE          240              12..max
+ *                EVT_BUF/MODE          1                M_BUF_xxx (not 0)
+ *                EVT_BUF/TIMEOUT       0                0..max
+ *                EVT_BUF/HIGHWATER     0                0..max
+ *                EVT_BUF/MASK          0                0..0xffffffff
+ *                OUT_BUF/SIZE          8                0..max
+ *                OUT_BUF/MODE          0                M_BUF_xxx
+ *                OUT_BUF/TIMEOUT       0                0..max
+ *                OUT_BUF/LOWWATER      0                0..max
+ *                IRQ_MOD/THRESHOLD     0                0..max
+ *                IRQ_MOD/PERIOD        10               1..max
+ *                IRQ_MOD/HOLD          10               1..max
+ *
+ *                ID_CACHE enables the id prom cache. The id prom is read
+ *                once at init, the id check and M_LL_BLK_ID_DATA use the
+ *                cached data (see M58_ID_REFRESH setstat):
+ *
+ *                   0 = read id prom on each access
+ *                   1 = read id prom once (default)
  *
  *                TRIG_EDGE defines the trigger edge for data storage
  *                and interrupt generation:
@@ -265,8 +474,13 @@ static int32 M58_Info(int32     infoType, ... );
  *                   0 = disable
  *                   1 = enable
  *
+ *                DEBOUNCE and DEBOUNCE_MASK define the debounce filter of
+ *                input channel n (see M58_DEBOUNCE/M58_DEBOUNCE_MASK
+ *                setstats).
+ *
  *                SIZE defines the size of the input buffer [bytes]
- *                (minimum size is 8).
+ *                (minimum size is 8). With TIMESTAMP=1 or CAPTURE=1, SIZE
+ *                must be a multiple of the M58_TS_REC size (12).
  *
  *                MODE defines the buffer's block i/o mode (see MDIS-Doc.):
  *
@@ -281,6 +495,46 @@ static int32 M58_Info(int32     infoType, ... );
  *                HIGHWATER defines the buffer level in [bytes], of the
  *                corresponding highwater buffer event (see MDIS-Doc.).
  *
+ *                TIMESTAMP defines the input buffer record format
+ *                (see M58_Irq):
+ *
+ *                   0 = raw frames
+ *                   1 = timestamped records (M58_TS_REC)
+ *
+ *                CAPTURE and CHANGE_MASK define the change-only capture
+ *                mode (see M58_BUF_CAPTURE/M58_CAPT_MASK setstats).
+ *
+ *                PERIOD defines the periodic sampling period [msec]
+ *                (0 = off, see M58_SMP_PERIOD setstat).
+ *
+ *                WINDOW/PRE and POST define the default pre-/post-trigger
+ *                records of the capture window. Their sum defines the size
+ *                of the window history, which can't be changed later
+ *                (0 = no capture window, see M58_WIN_xxx setstats).
+ *
+ *                MATCH/MODE defines the pattern match actions (see
+ *                M58_MATCH_MODE setstat). MATCH/MASK_n and MATCH/VALUE_n
+ *                define the match table entries n=0..7 (see M58_BLK_MATCH
+ *                setstat). The table ends at the first missing MASK_n.
+ *
+ *                EVT_BUF/SIZE, MODE, TIMEOUT and HIGHWATER define the edge
+ *                event buffer in the same way (minimum size is one
+ *                M58_EVT_REC). M_BUF_USRCTRL is not allowed.
+ *
+ *                EVT_BUF/MASK defines the input bits generating edge
+ *                events (see M58_EVT_MASK setstat).
+ *
+ *                OUT_BUF/SIZE, MODE and TIMEOUT define the output buffer
+ *                in the same way (minimum size is 8). The output buffer
+ *                is used with the M_BUF_RINGBUF and M_BUF_RINGBUF_OVERWR
+ *                modes only (see M58_BlockWrite).
+ *
+ *                LOWWATER defines the output buffer level in [bytes], of
+ *                the corresponding lowwater buffer event (see MDIS-Doc.).
+ *
+ *                IRQ_MOD/THRESHOLD, PERIOD and HOLD define the interrupt
+ *                moderation (see M58_MOD_xxx setstats).
+ *
  *---------------------------------------------------------------------------
  *  Input......:  descSpec   pointer to descriptor data
  *                osHdl      oss handle
@@ -302,8 +556,10 @@ static int32 M58_Init(
 {
 	LL_HANDLE *llHdl = NULL;
 	u_int32 bufSize, bufMode, bufTout, bufHigh, bufDbgLevel;
+	u_int32 wrBufSize, wrBufMode, wrBufTout, wrBufLow;
+	u_int32 evtBufSize, evtBufMode, evtBufTout, evtBufHigh;
+	u_int32 smpPeriod;
 	u_int32 gotsize, value, n;
-	u_int16 ctrl;
 	int32 error;
 
 	/*------------------------------+
@@ -321,11 +577,14 @@ static int32 M58_Init(
 	llHdl->memAlloc   = gotsize;
 	llHdl->osHdl      = osHdl;
 	llHdl->irqHdl     = irqHdl;
+	llHdl->devSemHdl  = devSemHdl;
 	llHdl->ma         = *ma;
 	llHdl->portReg[0] = PORTA_REG;
 	llHdl->portReg[1] = PORTB_REG;
 	llHdl->portReg[2] = PORTC_REG;
 	llHdl->portReg[3] = PORTD_REG;
+	llHdl->rdSamples  = 1;
+	llHdl->captMask   = 0xffffffff;
 
 	/*------------------------------+
 	|  init id function table       |
@@ -380,6 +639,12 @@ static int32 M58_Init(
 		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
+	/* ID_CACHE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, TRUE,
+								&llHdl->idCache, "ID_CACHE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
 	/* TRIG_EDGE */
 	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00,
 								&llHdl->trigEdge, "TRIG_EDGE")) &&
@@ -426,8 +691,29 @@ static int32 M58_Init(
 
 		if (llHdl->bufEnable[n] > 0x01)
 			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+		/* CHANNEL_n/DEBOUNCE */
+		if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->dbCount[n],
+									"CHANNEL_%d/DEBOUNCE", n)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		if (llHdl->dbCount[n] > 0xff)
+			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+		/* CHANNEL_n/DEBOUNCE_MASK */
+		if ((error = DESC_GetUInt32(llHdl->descHdl, 0xff, &llHdl->dbChMask[n],
+									"CHANNEL_%d/DEBOUNCE_MASK", n)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		if (llHdl->dbChMask[n] > 0xff)
+			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
 	}
 
+	/* calculate debounce params */
+	CalcDebounce(llHdl);
+
 	/* SIZE */
 	if ((error = DESC_GetUInt32(llHdl->descHdl, 8, &bufSize,
 								"IN_BUF/SIZE")) &&
@@ -455,6 +741,179 @@ static int32 M58_Init(
 		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
+	/* TIMESTAMP */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->tsEnable,
+								"IN_BUF/TIMESTAMP")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->tsEnable > 0x01)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* CAPTURE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, M58_CAPT_ALL, &llHdl->captMode,
+								"IN_BUF/CAPTURE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->captMode > M58_CAPT_CHANGE)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* timestamped records must not be split at buffer end */
+	if ((llHdl->tsEnable || llHdl->captMode == M58_CAPT_CHANGE) &&
+		(bufSize % sizeof(M58_TS_REC)))
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	llHdl->inBufSize = bufSize;
+
+	/* CHANGE_MASK */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0xffffffff, &llHdl->captMask,
+								"IN_BUF/CHANGE_MASK")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* OUT_BUF/SIZE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 8, &wrBufSize,
+								"OUT_BUF/SIZE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (wrBufSize < 8)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* OUT_BUF/MODE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, M_BUF_USRCTRL, &wrBufMode,
+								"OUT_BUF/MODE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* OUT_BUF/TIMEOUT */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &wrBufTout,
+								"OUT_BUF/TIMEOUT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* OUT_BUF/LOWWATER */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &wrBufLow,
+								"OUT_BUF/LOWWATER")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* PERIOD */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &smpPeriod,
+								"IN_BUF/PERIOD")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* IRQ_MOD/THRESHOLD */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->modThresh,
+								"IRQ_MOD/THRESHOLD")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* IRQ_MOD/PERIOD */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 10, &llHdl->modPeriod,
+								"IRQ_MOD/PERIOD")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->modPeriod == 0)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* IRQ_MOD/HOLD */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 10, &llHdl->modHold,
+								"IRQ_MOD/HOLD")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->modHold == 0)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* EVT_BUF/SIZE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 20*sizeof(M58_EVT_REC),
+								&evtBufSize, "EVT_BUF/SIZE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (evtBufSize < sizeof(M58_EVT_REC))
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* EVT_BUF/MODE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, M_BUF_RINGBUF, &evtBufMode,
+								"EVT_BUF/MODE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (evtBufMode == M_BUF_USRCTRL)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* EVT_BUF/TIMEOUT */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &evtBufTout,
+								"EVT_BUF/TIMEOUT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* EVT_BUF/HIGHWATER */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &evtBufHigh,
+								"EVT_BUF/HIGHWATER")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* EVT_BUF/MASK */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->evtMask,
+								"EVT_BUF/MASK")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* WINDOW/PRE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->winPre,
+								"WINDOW/PRE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	/* WINDOW/POST */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->winPost,
+								"WINDOW/POST")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	llHdl->winDepth = llHdl->winPre + llHdl->winPost;
+
+	if (llHdl->winDepth < llHdl->winPre)	/* overflow */
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* MATCH/MODE */
+	if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00, &llHdl->matMode,
+								"MATCH/MODE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->matMode > M58_MATCH_ALL)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	/* match table */
+	for (n=0; n<M58_MATCH_MAX; n++) {
+		/* MATCH/MASK_n */
+		if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00,
+									&llHdl->matMask[n],
+									"MATCH/MASK_%d", n))) {
+			if (error != ERR_DESC_KEY_NOTFOUND)
+				return( Cleanup(llHdl,error) );
+			break;
+		}
+
+		/* MATCH/VALUE_n */
+		if ((error = DESC_GetUInt32(llHdl->descHdl, 0x00,
+									&llHdl->matValue[n],
+									"MATCH/VALUE_%d", n)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		llHdl->matBits |= llHdl->matMask[n];
+	}
+
+	llHdl->matCount = n;
+
 	/* calculate buffer params */
 	llHdl->bufRdSize  = CalcBufSize(llHdl, PORT_DIR_IN);
 	llHdl->bufWrSize  = CalcBufSize(llHdl, PORT_DIR_OUT);
@@ -471,12 +930,71 @@ static int32 M58_Init(
 	/* set debug level */
 	MBUF_SetStat(llHdl->bufHdl, NULL, M_BUF_RD_DEBUG_LEVEL, bufDbgLevel);
 
+	/* create output buffer */
+	if ((error = MBUF_Create(llHdl->osHdl, devSemHdl, llHdl,
+							 wrBufSize, 1, wrBufMode, MBUF_WR,
+							 wrBufLow, wrBufTout, irqHdl, &llHdl->wrBufHdl)))
+		return( Cleanup(llHdl,error) );
+
+	llHdl->wrDrain = (wrBufMode == M_BUF_RINGBUF ||
+					  wrBufMode == M_BUF_RINGBUF_OVERWR);
+
+	/* set debug level */
+	MBUF_SetStat(NULL, llHdl->wrBufHdl, M_BUF_WR_DEBUG_LEVEL, bufDbgLevel);
+
+	/* create event buffer */
+	if ((error = MBUF_Create(llHdl->osHdl, devSemHdl, llHdl,
+							 evtBufSize, 1, evtBufMode, MBUF_RD,
+							 evtBufHigh, evtBufTout, irqHdl, &llHdl->evtBufHdl)))
+		return( Cleanup(llHdl,error) );
+
+	/* set debug level */
+	MBUF_SetStat(llHdl->evtBufHdl, NULL, M_BUF_RD_DEBUG_LEVEL, bufDbgLevel);
+
+	/* create playback semaphore */
+	if ((error = OSS_SemCreate(llHdl->osHdl, OSS_SEM_BIN, 0, &llHdl->pbSem)))
+		return( Cleanup(llHdl,error) );
+
+	/* alloc capture window history */
+	if (llHdl->winDepth) {
+		if ((llHdl->winBuf = (u_int8*)OSS_MemGet(llHdl->osHdl,
+									llHdl->winDepth * sizeof(M58_TS_REC),
+									&llHdl->winAlloc)) == NULL)
+			return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+	}
+
+	/* create trigger wait semaphore */
+	if ((error = OSS_SemCreate(llHdl->osHdl, OSS_SEM_BIN, 0, &llHdl->waitSem)))
+		return( Cleanup(llHdl,error) );
+
+	/* create sample alarm */
+	if ((error = OSS_AlarmCreate(llHdl->osHdl, SampleAlarm, llHdl,
+								 &llHdl->alarmHdl)))
+		return( Cleanup(llHdl,error) );
+
+	/* create moderation alarm */
+	if ((error = OSS_AlarmCreate(llHdl->osHdl, ModAlarm, llHdl,
+								 &llHdl->modAlarmHdl)))
+		return( Cleanup(llHdl,error) );
+
 	/*------------------------------+
 	|  check module id              |
 	+------------------------------*/
+	/* fill id prom cache */
+	if (llHdl->idCache)
+		ReadIdProm(llHdl);
+
 	if (llHdl->idCheck) {
-		int modIdMagic = m_read((U_INT32_OR_64)llHdl->ma, 0);
-		int modId      = m_read((U_INT32_OR_64)llHdl->ma, 1);
+		int modIdMagic, modId;
+
+		if (llHdl->idValid) {
+			modIdMagic = llHdl->idData[0];
+			modId      = llHdl->idData[1];
+		}
+		else {
+			modIdMagic = m_read((U_INT32_OR_64)llHdl->ma, 0);
+			modId      = m_read((U_INT32_OR_64)llHdl->ma, 1);
+		}
 
 		if (modIdMagic != MOD_ID_MAGIC) {
 			DBGWRT_ERR((DBH," *** M58_Init: illegal magic=0x%04x\n",modIdMagic));
@@ -494,7 +1012,8 @@ static int32 M58_Init(
 	|  init hardware                |
 	+------------------------------*/
 	/* disable irqs */
-	MWRITE_D16(llHdl->ma, CTRL3_REG, 0x00);
+	llHdl->ctrl3 = 0x00;
+	MWRITE_D16(llHdl->ma, CTRL3_REG, llHdl->ctrl3);
 
 	/* reset all ports */
 	MWRITE_D8(llHdl->ma, PORTA_REG, 0x00);
@@ -503,26 +1022,34 @@ static int32 M58_Init(
 	MWRITE_D8(llHdl->ma, PORTD_REG, 0x00);
 
 	/* config port dir */
-	ctrl = (u_int16)((llHdl->portDir[3] << 3) |
-					 (llHdl->portDir[2] << 2) |
-					 (llHdl->portDir[1] << 1) |
-					 (llHdl->portDir[0] << 0));
+	llHdl->ctrl0 = (u_int16)((llHdl->portDir[3] << 3) |
+							 (llHdl->portDir[2] << 2) |
+							 (llHdl->portDir[1] << 1) |
+							 (llHdl->portDir[0] << 0));
 
-	MWRITE_D16(llHdl->ma, CTRL0_REG, ctrl);
+	MWRITE_D16(llHdl->ma, CTRL0_REG, llHdl->ctrl0);
 
 	/* config port term */
-	ctrl = (u_int16)((llHdl->portTerm[3] << 3) |
-					 (llHdl->portTerm[2] << 2) |
-					 (llHdl->portTerm[1] << 1) |
-					 (llHdl->portTerm[0] << 0));
+	llHdl->ctrl1 = (u_int16)((llHdl->portTerm[3] << 3) |
+							 (llHdl->portTerm[2] << 2) |
+							 (llHdl->portTerm[1] << 1) |
+							 (llHdl->portTerm[0] << 0));
 
-	MWRITE_D16(llHdl->ma, CTRL1_REG, ctrl);
+	MWRITE_D16(llHdl->ma, CTRL1_REG, llHdl->ctrl1);
 
 	/* config trigger/data mode */
-	ctrl = (u_int16)((llHdl->trigEdge << 3) |
-					 (llHdl->dataMode << 0));
+	llHdl->ctrl2 = (u_int16)((llHdl->trigEdge << 3) |
+							 (llHdl->dataMode << 0));
+
+	MWRITE_D16(llHdl->ma, CTRL2_REG, llHdl->ctrl2);
 
-	MWRITE_D16(llHdl->ma, CTRL2_REG, ctrl);
+	/* start periodic sampling */
+	if (smpPeriod && (error = SetSamplePeriod(llHdl, smpPeriod)))
+		return( Cleanup(llHdl,error) );
+
+	/* start interrupt moderation */
+	if ((error = SetModeration(llHdl)))
+		return( Cleanup(llHdl,error) );
 
 	return(ERR_SUCCESS);
 }
@@ -531,7 +1058,8 @@ static int32 M58_Init(
  *
  *  Description:  De-initialize hardware and cleanup memory
  *
- *                The function deinitializes all channels by setting them
+ *                The function stops periodic sampling and interrupt
+ *                moderation and deinitializes all channels by setting them
  *                to input direction and passive termination. The interrupt
  *                is disabled.
  *
@@ -545,16 +1073,33 @@ static int32 M58_Exit(
 )
 {
 	LL_HANDLE *llHdl = *llHdlP;
+	OSS_IRQ_STATE irqState;
 	int32 error = 0;
 
 	DBGWRT_1((DBH, "LL - M58_Exit\n"));
 
+	/* stop periodic sampling */
+	SetSamplePeriod(llHdl, 0);
+
+	/* stop irq moderation, don't let ModAlarm re-arm the irq */
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	llHdl->modThresh = 0;
+	llHdl->modLeft   = 0;
+	llHdl->irqEnable = FALSE;
+	llHdl->ctrl3     = 0x00;
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+	if (llHdl->modActive) {
+		OSS_AlarmClear(llHdl->osHdl, llHdl->modAlarmHdl);
+		llHdl->modActive = FALSE;
+	}
+
 	/*------------------------------+
 	|  de-init hardware             |
 	+------------------------------*/
 	MWRITE_D16(llHdl->ma, CTRL0_REG, 0x0f);		/* all inputs */
 	MWRITE_D16(llHdl->ma, CTRL1_REG, 0x0f);		/* all passive */
-	MWRITE_D16(llHdl->ma, CTRL3_REG, 0x00);		/* disable irq */
+	MWRITE_D16(llHdl->ma, CTRL3_REG, llHdl->ctrl3);	/* disable irq */
 
 	/*------------------------------+
 	|  cleanup memory               |
@@ -576,6 +1121,10 @@ static int32 M58_Exit(
  *                If the channel's direction is not configured as input
  *                an ERR_LL_ILL_DIR error is returned.
  *
+ *                If the debounce filter of the channel is enabled, the
+ *                filtered value is returned. Each call counts as one
+ *                sample of the filter (see M58_DEBOUNCE).
+ *
  *                Notes
  *                -----
  *                Pay attention to your correct channel configuration and
@@ -595,14 +1144,24 @@ static int32 M58_Read(
 	int32 *value
 )
 {
+	OSS_IRQ_STATE irqState;
+	u_int32 shift = ch * 8;
+
 	DBGWRT_1((DBH, "LL - M58_Read: ch=%d\n",ch));
 
 	/* check channel direction */
 	if (llHdl->portDir[ch] !=  PORT_DIR_IN)
 		return(ERR_LL_ILL_DIR);
 
-	/* read channel */
+	/* read channel (debounce filter and bus counters shared with M58_Irq) */
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
 	*value = MREAD_D8(llHdl->ma, llHdl->portReg[ch]) & 0xff;
+	llHdl->statBusD8++;
+
+	if (llHdl->dbMask & ((u_int32)0xff << shift))
+		*value = (Debounce(llHdl, (u_int32)*value << shift,
+						   (u_int32)0xff << shift) >> shift) & 0xff;
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
 
 	return(ERR_SUCCESS);
 }
@@ -619,6 +1178,9 @@ static int32 M58_Read(
  *                If the channel's direction is not configured as output
  *                an ERR_LL_ILL_DIR error is returned.
  *
+ *                The value is also kept in the output shadow, which is
+ *                shared with the reflex rules (see M58_BLK_REFLEX).
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl    ll handle
  *                ch       current channel
@@ -632,14 +1194,18 @@ static int32 M58_Write(
 	int32 value
 )
 {
+	OSS_IRQ_STATE irqState;
+
 	DBGWRT_1((DBH, "LL - M58_Write: ch=%d, value=0x%x, llHdl->ma=0x%x\n",ch,value,llHdl->ma));
 
 	/* check channel direction */
 	if (llHdl->portDir[ch] !=  PORT_DIR_OUT)
 		return(ERR_LL_ILL_DIR);
 
-	/* write channel */
-	MWRITE_D8(llHdl->ma, llHdl->portReg[ch], value & 0xff);
+	/* write channel (output shadow is shared with M58_Irq) */
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	WritePort(llHdl, ch, (u_int8)value);
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
 
 	return(ERR_SUCCESS);
 }
@@ -657,7 +1223,7 @@ static int32 M58_Write(
  *                M_LL_IRQ_COUNT       interrupt counter          0..max
  *                M_LL_CH_DIR          direction of curr chan     M_CH_IN,
  *                                                                M_CH_OUT
- *                M_BUF_xxx            input buffer codes         see MDIS
+ *                M_BUF_xxx            in/output buffer codes     see MDIS
  *                -------------------  -------------------------  ----------
  *                M58_BUF_ENABLE       block i/o of curr chan     0..1
  *                M58_PORT_TERM        termination of curr chan   0..1
@@ -665,6 +1231,43 @@ static int32 M58_Write(
  *                M58_DATA_MODE        data storage mode          0..7
  *                M58_TRIG_SIG_SET     trigger signal enable      1..max
  *                M58_TRIG_SIG_CLR     trigger signal disable     -
+ *                M58_RD_SAMPLES       direct input frames/read   0..max
+ *                M58_RD_PACE          direct input period [usec] 0..max
+ *                M58_WR_PLAYBACK      block write playback mode  0..2
+ *                M58_WR_PACE          timed playback [usec]      0..max
+ *                M58_WR_TIMEOUT       trig. playback tout [msec] 0..max
+ *                M58_BUF_TSTAMP       timestamped input records  0..1
+ *                M58_STATS_CLR        clear statistics           -
+ *                M58_BUF_CAPTURE      input buffer capture mode  0..1
+ *                M58_CAPT_MASK        change detection mask      0..0xffffffff
+ *                M58_EVT_MASK         edge event mask            0..0xffffffff
+ *                M58_RD_SOURCE        block read source          0..2
+ *                M58_DEBOUNCE         debounce count of curr chan 0..255
+ *                M58_DEBOUNCE_MASK    debounce mask of curr chan 0..0xff
+ *                M58_CNT_RISE         rising  edge counter mask  0..0xffffffff
+ *                M58_CNT_FALL         falling edge counter mask  0..0xffffffff
+ *                M58_CNT_CLR          clear pulse counters       -
+ *                M58_SMP_PERIOD       periodic sampling [msec]   0..max
+ *                M58_MOD_THRESH       irq moderation threshold   0..max
+ *                M58_MOD_PERIOD       irq moderation poll [msec] 1..max
+ *                M58_MOD_HOLD         irq moderation hold        1..max
+ *                M58_SIG_EVERY        signal every n triggers    0..max
+ *                M58_SIG_MINTIME      min. signal interval[usec] 0..max
+ *                M58_SIG_FILL         signal fill threshold      0..max
+ *                M58_WIN_PRE          pre-trigger records        0..max
+ *                M58_WIN_POST         post-trigger records       1..max
+ *                M58_WIN_MASK         window arm condition mask  0..0xffffffff
+ *                M58_WIN_VALUE        window arm condition value 0..0xffffffff
+ *                M58_WIN_ARM          arm/disarm capture window  0..1
+ *                M58_MATCH_MODE       pattern match actions      0..7
+ *                M58_OUT_SET_MASK     set output bits            0..0xffffffff
+ *                M58_OUT_CLR_MASK     clear output bits          0..0xffffffff
+ *                M58_OUT_TOGGLE_MASK  toggle output bits         0..0xffffffff
+ *                M58_PORTS_ALL        write all output channels  0..0xffffffff
+ *                M58_ID_REFRESH       re-read id prom into cache -
+ *                -------------------  -------------------------  ----------
+ *                M58_BLK_MATCH        match table (M58_MATCH[])  -
+ *                M58_BLK_REFLEX       reflex rules (M58_REFLEX[]) -
  *                -------------------  -------------------------  ----------
  *
  *                With M_LL_CH_DIR the direction of the current channel can
@@ -676,6 +1279,10 @@ static int32 M58_Write(
  *                   0 = disable
  *                   1 = enable
  *
+ *                M_LL_CH_DIR and M58_BUF_ENABLE change the frame size. They
+ *                return ERR_LL_DEV_BUSY while a triggered playback
+ *                (M58_PB_TRIG) is running.
+ *
  *                M58_PORT_TERM defines the termination of current channel:
  *
  *                   0 = active  (M58_TERM_ACTIVE)
@@ -714,8 +1321,233 @@ static int32 M58_Write(
  *
  *                M58_TRIG_SIG_CLR disables the trigger signal.
  *
+ *                M58_SIG_EVERY, M58_SIG_MINTIME and M58_SIG_FILL coalesce
+ *                the trigger signal. A signal is only sent if all of the
+ *                enabled conditions are met (all 0 = signal on every
+ *                trigger, default):
+ *
+ *                   M58_SIG_EVERY    at least n triggers since last signal
+ *                   M58_SIG_MINTIME  at least t usec since last signal
+ *                                    (rounded up to OSS ticks)
+ *                   M58_SIG_FILL     input buffer fill level reached the
+ *                                    given number of bytes (once, re-armed
+ *                                    when the fill level drops below)
+ *
+ *                The number of triggers since the last signal can be
+ *                queried via the M58_SIG_PENDING getstat.
+ *
+ *                M58_RD_SAMPLES defines how many frames M58_BlockRead
+ *                samples in direct input mode (M_BUF_USRCTRL):
+ *
+ *                   0 = as many frames as fit into the user buffer
+ *                   1 = one frame (default)
+ *                   n = n frames (limited by the user buffer size)
+ *
+ *                M58_RD_PACE defines the delay [usec] between two frames
+ *                sampled by one M58_BlockRead call (0 = full bus speed).
+ *
+ *                M58_WR_PLAYBACK defines how M58_BlockWrite emits the
+ *                frames of the user buffer (see M58_BlockWrite Function):
+ *
+ *                   0 = one frame only (M58_PB_SINGLE, default)
+ *                   1 = all frames, timed (M58_PB_TIMED)
+ *                   2 = all frames, one per trigger (M58_PB_TRIG)
+ *
+ *                M58_WR_PACE defines the delay [usec] between two frames
+ *                in timed playback mode (0 = full bus speed).
+ *
+ *                M58_WR_TIMEOUT defines the timeout [msec] for triggered
+ *                playback (0 = no timeout).
+ *
+ *                M58_BUF_TSTAMP defines the input buffer record format
+ *                (see M58_Irq Function):
+ *
+ *                   0 = raw frames
+ *                   1 = timestamped records (M58_TS_REC)
+ *
+ *                Timestamped records require an input buffer size, which
+ *                is a multiple of the M58_TS_REC size (ERR_LL_ILL_PARAM,
+ *                see descriptor key IN_BUF/SIZE). The input buffer is
+ *                flushed when the record format changes, so that it never
+ *                holds records of different size.
+ *
+ *                M58_STATS_CLR clears all statistic counters (see
+ *                M58_BLK_STATS getstat), the missed sample periods
+ *                (see M58_SMP_MISSED getstat) and the pattern match hits
+ *                (see M58_MATCH_HITS getstat).
+ *
+ *                M58_BUF_CAPTURE defines which frames M58_Irq stores into
+ *                the input buffer (see M58_Irq Function):
+ *
+ *                   0 = every frame (M58_CAPT_ALL, default)
+ *                   1 = changed frames only (M58_CAPT_CHANGE)
+ *
+ *                M58_CAPT_MASK defines the input bits compared in change-only
+ *                capture mode (port A..D = bit 0..7, 8..15, 16..23, 24..31,
+ *                default 0xffffffff).
+ *
+ *                Setting M58_BUF_CAPTURE or M58_CAPT_MASK forces the next
+ *                frame to be stored.
+ *
+ *                M58_EVT_MASK defines the input bits (bit layout as for
+ *                M58_CAPT_MASK) for which M58_Irq stores edge events into
+ *                the event buffer (0 = no events, default). Input channels
+ *                of the mask, which are not enabled for block i/o, are
+ *                read in addition on each sample.
+ *
+ *                M58_RD_SOURCE defines the buffer read by M58_BlockRead
+ *                and addressed by the M_BUF_RD_xxx codes:
+ *
+ *                   0 = input buffer (M58_SRC_FRAMES, default)
+ *                   1 = event buffer (M58_SRC_EVENTS)
+ *                   2 = capture window (M58_SRC_WINDOW, M_BUF_RD_xxx
+ *                       codes address the input buffer)
+ *
+ *                M58_DEBOUNCE defines the debounce filter of the current
+ *                channel. A filtered input bit changes its state only after
+ *                the new level was sampled N times in a row (0,1 = no
+ *                filter). The filter runs on every sample taken by M58_Irq,
+ *                M58_BlockRead (direct input) and M58_Read, and the filtered
+ *                values are returned/buffered instead of the raw values.
+ *
+ *                M58_DEBOUNCE_MASK defines which bits of the current channel
+ *                are filtered (default 0xff).
+ *
+ *                Setting M58_DEBOUNCE or M58_DEBOUNCE_MASK restarts the
+ *                filter of all channels (the next sample is taken as
+ *                stable state).
+ *
+ *                M58_CNT_RISE/M58_CNT_FALL define the input bits (bit layout
+ *                as for M58_CAPT_MASK) whose rising/falling edges are
+ *                counted by M58_Irq (0 = none, default). A bit set in both
+ *                masks counts both edges. Input channels of the masks,
+ *                which are not enabled for block i/o, are read in addition
+ *                on each sample.
+ *
+ *                M58_CNT_CLR clears all pulse counters (see M58_BLK_COUNTERS
+ *                getstat).
+ *
+ *                M58_SMP_PERIOD starts periodic sampling with the given
+ *                period [msec] (0 = stop, default). An OSS alarm takes one
+ *                sample per period in the same way as M58_Irq does on each
+ *                trigger (input buffer, edge events, pulse counters), but
+ *                without output and signal handling. The input buffer
+ *                highwater and timeout settings apply as usual. Use data
+ *                storage mode 0 or 1, since no trigger edge latches the
+ *                inputs. The period is rounded by the OSS alarm.
+ *
+ *                M58_MOD_THRESH enables interrupt moderation (0 = off,
+ *                default). If more than the given number of triggers occur
+ *                within one poll period (M58_MOD_PERIOD, default 10 msec),
+ *                the trigger interrupt is disabled and the inputs are
+ *                sampled once per poll period instead (like periodic
+ *                sampling, without output and signal handling). After
+ *                M58_MOD_HOLD poll periods (default 10), the interrupt is
+ *                re-enabled, regardless of the current trigger rate (the
+ *                trigger rate cannot be measured while polled). If the
+ *                trigger storm continues, the driver falls back to polled
+ *                mode again. The switches to polled mode are counted (see
+ *                M58_BLK_STATS).
+ *                While polled, no triggers are seen: the output buffer is
+ *                not drained, a triggered playback (M58_PB_TRIG) does not
+ *                advance, M58_BLK_WAIT_TRIG does not count triggers (only
+ *                its fill level is checked) and no trigger signal is sent.
+ *
+ *                M58_WIN_xxx control the capture window. While armed, each
+ *                sample (trigger, periodic or polled) is recorded into a
+ *                circular history, overwriting the oldest record. When the
+ *                arm condition fires, the M58_WIN_PRE records before and
+ *                the M58_WIN_POST records from the firing sample on are
+ *                frozen into one capture, which M58_BlockRead returns with
+ *                M58_RD_SOURCE = M58_SRC_WINDOW (see M58_BlockRead Function).
+ *                The records have the input buffer record format, but are
+ *                independent of the input buffer and the capture mode.
+ *
+ *                M58_WIN_PRE/M58_WIN_POST define the pre-/post-trigger
+ *                records (PRE+POST must not exceed the history size defined
+ *                by the descriptor). M58_WIN_MASK/M58_WIN_VALUE define the
+ *                arm condition (bit layout as for M58_CAPT_MASK): the window
+ *                fires when (inputs & MASK) == VALUE becomes true, e.g. for
+ *                an edge of one bit or a bit pattern. With MASK = 0 the
+ *                window fires on the next trigger, as soon as the pre-trigger
+ *                history is complete.
+ *
+ *                M58_WIN_ARM arms (1) or disarms (0) the capture window.
+ *                Arming discards a previous capture. The settings can't be
+ *                changed while armed (ERR_LL_DEV_BUSY). Changing the input
+ *                channel configuration disarms the window.
+ *
+ *                M58_BLK_MATCH loads the pattern match table, an array of
+ *                up to M58_MATCH_MAX mask/value pairs (M58_MATCH structure,
+ *                bit layout as for M58_CAPT_MASK). A sample matches, if
+ *                (inputs & mask) == value for any entry (size 0 = empty
+ *                table, never matches). Input channels of the masks, which
+ *                are not enabled for block i/o, are read in addition on
+ *                each sample, so M58_MATCH_SIG also works without input
+ *                buffer.
+ *
+ *                M58_MATCH_MODE defines what M58_Irq does only on a hit
+ *                (OR'ed flags, 0 = off, default):
+ *
+ *                   M58_MATCH_STORE  store the frame into the input buffer
+ *                   M58_MATCH_SIG    send the trigger signal
+ *                   M58_MATCH_EDGE   hit = transition into match only
+ *                                    (otherwise every matching sample)
+ *
+ *                Other frames/signals are suppressed. Stored frames are
+ *                still subject to the capture mode, signals to the signal
+ *                coalescing. The number of hits can be queried via the
+ *                M58_MATCH_HITS getstat.
+ *
+ *                M58_BLK_REFLEX loads the reflex rules, an array of up to
+ *                M58_RFL_MAX rules (M58_REFLEX structure, size 0 = no
+ *                rules). The rules are evaluated in table order on each
+ *                sample (trigger, periodic or polled), right after the
+ *                inputs were read. If (inputs & mask) == value, the action
+ *                is applied to the output channel (see M58_Write):
+ *
+ *                   M58_RFL_SET    set the data bits
+ *                   M58_RFL_CLR    clear the data bits
+ *                   M58_RFL_XOR    toggle the data bits
+ *                   M58_RFL_WRITE  write the data value
+ *
+ *                With M58_RFL_EDGE OR'ed to the action, the rule only
+ *                fires on the transition into the condition. Rules for a
+ *                channel not configured as output are skipped. Input
+ *                channels used by a condition but not enabled for block
+ *                i/o are read additionally on each sample, output channels
+ *                compare against the output shadow. On an output channel
+ *                enabled for block i/o, the next value from the output
+ *                buffer (drain or playback, see M58_Irq) overwrites the
+ *                action of a rule.
+ *                Loading the rules clears the hit counters (see
+ *                M58_BLK_REFLEX_HITS getstat).
+ *
+ *                M58_OUT_SET_MASK/M58_OUT_CLR_MASK/M58_OUT_TOGGLE_MASK set,
+ *                clear or toggle the given output bits (bit layout as for
+ *                M58_CAPT_MASK) in one atomic step. The driver applies the
+ *                mask to its output shadow (the values last written by
+ *                M58_Write, block i/o or reflex rules) and writes only the
+ *                ports that changed. No read-back is done. If the mask
+ *                contains bits of a channel not configured as output,
+ *                ERR_LL_ILL_DIR is returned and nothing is written.
+ *
+ *                M58_PORTS_ALL writes all output channels from one 32-bit
+ *                value (port A..D = bit 0..7, 8..15, 16..23, 24..31). Bits
+ *                of channels not configured as output are ignored. All
+ *                output channels are written, so that the ports and the
+ *                output shadow are in sync afterwards.
+ *
+ *                M58_ID_REFRESH re-reads the id prom into the id prom cache
+ *                (see M_LL_BLK_ID_DATA getstat). This also enables the
+ *                cache, if disabled by the ID_CACHE descriptor key.
+ *
  *                Notes
  *                -----
+ *                The control registers are never read back. The driver
+ *                keeps a shadow of each control register and writes the
+ *                whole register on every change.
+ *
  *                Changing M_LL_CH_DIR, M58_BUF_ENABLE or M58_DATA_MODE while
  *                block i/o is running, will cause unpredictable results !
  *
@@ -738,7 +1570,9 @@ static int32 M58_SetStat(
 {
 	int32       value = (int32)value32_or_64; /* 32bit value     */
 	/* INT32_OR_64 valueP = value32_or_64;       /\* stores 32/64bit pointer *\/ */
+	M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64;
 
+	OSS_IRQ_STATE irqState;
 	int32 error = ERR_SUCCESS;
 
 	DBGWRT_1((DBH, "LL - M58_SetStat: ch=%d code=0x%04x value=0x%x\n",
@@ -755,11 +1589,19 @@ static int32 M58_SetStat(
 		|  enable interrupts        |
 		+--------------------------*/
 		case M_MK_IRQ_ENABLE:
-			if (value) 			/* enable irqs */
-				MSETMASK_D16(llHdl->ma, CTRL3_REG, IEN);
-			else 				/* disable irqs */
-				MCLRMASK_D16(llHdl->ma, CTRL3_REG, IEN);
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->irqEnable = value ? TRUE : FALSE;
 
+			/* polled mode: irq is re-enabled by ModAlarm */
+			if (llHdl->modLeft == 0) {
+				if (value) 			/* enable irqs */
+					llHdl->ctrl3 |= IEN;
+				else 				/* disable irqs */
+					llHdl->ctrl3 &= ~IEN;
+
+				MWRITE_D16(llHdl->ma, CTRL3_REG, llHdl->ctrl3);
+			}
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
 			break;
 		/*--------------------------+
 		|  set irq counter          |
@@ -771,22 +1613,30 @@ static int32 M58_SetStat(
 		|  channel direction        |
 		+--------------------------*/
 		case M_LL_CH_DIR:
+			/* frame size fixed while triggered playback runs */
+			if (llHdl->pbLeft)
+				return(ERR_LL_DEV_BUSY);
+
 			switch(value) {
 				case M_CH_OUT:
 					llHdl->portDir[ch] = PORT_DIR_OUT;
-					MCLRMASK_D16(llHdl->ma, CTRL0_REG, 1<<ch);
+					llHdl->ctrl0 &= ~(1<<ch);
+					MWRITE_D16(llHdl->ma, CTRL0_REG, llHdl->ctrl0);
 					break;
 				case M_CH_IN:
 					llHdl->portDir[ch] = PORT_DIR_IN;
-					MSETMASK_D16(llHdl->ma, CTRL0_REG, 1<<ch);
+					llHdl->ctrl0 |= (1<<ch);
+					MWRITE_D16(llHdl->ma, CTRL0_REG, llHdl->ctrl0);
 					break;
 				default:
 					error = ERR_LL_ILL_PARAM;
 			}
 
-			/* update buffer params */
+			/* update buffer params (plans are walked by M58_Irq) */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
 			llHdl->bufRdSize  = CalcBufSize(llHdl, PORT_DIR_IN);
 			llHdl->bufWrSize  = CalcBufSize(llHdl, PORT_DIR_OUT);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
 
 			break;
 		/*--------------------------+
@@ -796,11 +1646,13 @@ static int32 M58_SetStat(
 			switch(value) {
 				case M58_TERM_ACTIVE:
 					llHdl->portTerm[ch] = value;
-					MCLRMASK_D16(llHdl->ma, CTRL1_REG, 1<<ch);
+					llHdl->ctrl1 &= ~(1<<ch);
+					MWRITE_D16(llHdl->ma, CTRL1_REG, llHdl->ctrl1);
 					break;
 				case M58_TERM_PASSIVE:
 					llHdl->portTerm[ch] = value;
-					MSETMASK_D16(llHdl->ma, CTRL1_REG, 1<<ch);
+					llHdl->ctrl1 |= (1<<ch);
+					MWRITE_D16(llHdl->ma, CTRL1_REG, llHdl->ctrl1);
 					break;
 				default:
 					error = ERR_LL_ILL_PARAM;
@@ -814,11 +1666,13 @@ static int32 M58_SetStat(
 			switch(value) {
 				case M58_TRIG_FALL:
 					llHdl->trigEdge = value;
-					MCLRMASK_D16(llHdl->ma, CTRL2_REG, TR);
+					llHdl->ctrl2 &= ~TR;
+					MWRITE_D16(llHdl->ma, CTRL2_REG, llHdl->ctrl2);
 					break;
 				case M58_TRIG_RISE:
 					llHdl->trigEdge = value;
-					MSETMASK_D16(llHdl->ma, CTRL2_REG, TR);
+					llHdl->ctrl2 |= TR;
+					MWRITE_D16(llHdl->ma, CTRL2_REG, llHdl->ctrl2);
 					break;
 				default:
 					error = ERR_LL_ILL_PARAM;
@@ -833,8 +1687,8 @@ static int32 M58_SetStat(
 				return(ERR_LL_ILL_PARAM);
 
 			llHdl->dataMode = value;
-			MCLRMASK_D16(llHdl->ma, CTRL2_REG, CONFIG);
-			MSETMASK_D16(llHdl->ma, CTRL2_REG, value);
+			llHdl->ctrl2 = (u_int16)((llHdl->ctrl2 & ~CONFIG) | value);
+			MWRITE_D16(llHdl->ma, CTRL2_REG, llHdl->ctrl2);
 			break;
 		/*--------------------------+
 		|  trigger signal enable    |
@@ -854,6 +1708,11 @@ static int32 M58_SetStat(
 			if ((error = OSS_SigCreate(llHdl->osHdl, value, &llHdl->sigHdl)))
 				return(error);
 
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->sigPend  = 0;
+			llHdl->sigArmed = TRUE;
+			llHdl->sigLast  = OSS_TickGet(llHdl->osHdl) - llHdl->sigMinTicks;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
 			break;
 		/*--------------------------+
 		|  trigger signal disable   |
@@ -874,58 +1733,544 @@ static int32 M58_SetStat(
 		|  channel block i/o        |
 		+--------------------------*/
 		case M58_BUF_ENABLE:
+			/* frame size fixed while triggered playback runs */
+			if (llHdl->pbLeft)
+				return(ERR_LL_DEV_BUSY);
+
 			llHdl->bufEnable[ch] = value;
 
-			/* update buffer params */
+			/* update buffer params (plans are walked by M58_Irq) */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
 			llHdl->bufRdSize  = CalcBufSize(llHdl, PORT_DIR_IN);
 			llHdl->bufWrSize  = CalcBufSize(llHdl, PORT_DIR_OUT);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
 			break;
 		/*--------------------------+
-		|  MBUF + unknown           |
+		|  direct input frames      |
 		+--------------------------*/
-		default:
-			if (M_BUF_CODE(code))
-				error = MBUF_SetStat(llHdl->bufHdl, NULL, code, value);
-			else
-				error = ERR_LL_UNK_CODE;
-	}
+		case M58_RD_SAMPLES:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
 
-	return(error);
-}
+			llHdl->rdSamples = value;
+			break;
+		/*--------------------------+
+		|  direct input period      |
+		+--------------------------*/
+		case M58_RD_PACE:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
 
-/****************************** M58_GetStat **********************************
- *
- *  Description:  Get driver status
- *
- *                Following status codes are supported:
- *
- *                Code                 Description                Values
- *                -------------------  -------------------------  ----------
- *                M_LL_DEBUG_LEVEL     driver debug level         see oss.h
- *                M_LL_CH_NUMBER       number of channels         4
- *                M_LL_CH_DIR          direction of curr chan     M_CH_IN,
- *                                                                M_CH_OUT
- *                M_LL_CH_LEN          length of curr chan [bits] 1..max
- *                M_LL_CH_TYP          description of curr chan   M_CH_BINARY
- *                M_LL_IRQ_COUNT       interrupt counter          0..max
- *                M_LL_ID_CHECK        eeprom is checked          0..1
- *                M_LL_ID_SIZE         eeprom size [bytes]        128
- *                M_LL_BLK_ID_DATA     eeprom raw data            -
- *                M_MK_BLK_REV_ID      ident function table ptr   -
- *                M_BUF_xxx            input buffer codes         see MDIS
- *                -------------------  -------------------------  ----------
- *                M58_BUF_ENABLE       block i/o of curr chan     0..1
- *                M58_PORT_TERM        termination of curr chan   0..1
- *                M58_TRIG_EDGE        trigger edge               0..1
- *                M58_DATA_MODE        data storage mode          0..7
- *                M58_TRIG_SIG_SET     trigger signal code        0..max
- *                M58_BUF_RDSIZE       nr of enabled input  chan. 0..4
- *                M58_BUF_WRSIZE       nr of enabled output chan. 0..4
+			/* prepare OSS_MikroDelay */
+			if (value && !llHdl->rdPace &&
+				(error = OSS_MikroDelayInit(llHdl->osHdl)))
+				return(error);
+
+			llHdl->rdPace = value;
+			break;
+		/*--------------------------+
+		|  block write playback     |
+		+--------------------------*/
+		case M58_WR_PLAYBACK:
+			if (!IN_RANGE(value,M58_PB_SINGLE,M58_PB_TRIG))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->pbMode = value;
+			break;
+		case M58_WR_PACE:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			/* prepare OSS_MikroDelay */
+			if (value && !llHdl->pbPace &&
+				(error = OSS_MikroDelayInit(llHdl->osHdl)))
+				return(error);
+
+			llHdl->pbPace = value;
+			break;
+		case M58_WR_TIMEOUT:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->pbTout = value;
+			break;
+		/*--------------------------+
+		|  input record format      |
+		+--------------------------*/
+		case M58_BUF_TSTAMP:
+		{
+			int32 recSize;
+
+			if (!IN_RANGE(value,0,1))
+				return(ERR_LL_ILL_PARAM);
+
+			if (value && (llHdl->inBufSize % sizeof(M58_TS_REC)))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->tsEnable = value;
+
+			/* update buffer params (plans are walked by M58_Irq) */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			recSize = llHdl->recSize;
+			llHdl->bufRdSize  = CalcBufSize(llHdl, PORT_DIR_IN);
+
+			if (llHdl->recSize != recSize)
+				FlushInBuf(llHdl);
+
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		/*--------------------------+
+		|  change-only capture      |
+		+--------------------------*/
+		case M58_BUF_CAPTURE:
+		{
+			int32 recSize;
+
+			if (!IN_RANGE(value,M58_CAPT_ALL,M58_CAPT_CHANGE))
+				return(ERR_LL_ILL_PARAM);
+
+			if (value == M58_CAPT_CHANGE &&
+				(llHdl->inBufSize % sizeof(M58_TS_REC)))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->captMode = value;
+
+			/* update buffer params (plans are walked by M58_Irq) */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			recSize = llHdl->recSize;
+			llHdl->bufRdSize  = CalcBufSize(llHdl, PORT_DIR_IN);
+
+			if (llHdl->recSize != recSize)
+				FlushInBuf(llHdl);
+
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		case M58_CAPT_MASK:
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->captMask  = (u_int32)value;
+			llHdl->captValid = FALSE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		/*--------------------------+
+		|  edge events              |
+		+--------------------------*/
+		case M58_EVT_MASK:
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->evtMask  = (u_int32)value;
+			llHdl->evtValid = FALSE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		case M58_RD_SOURCE:
+			if (!IN_RANGE(value,M58_SRC_FRAMES,M58_SRC_WINDOW))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->rdSource = value;
+			break;
+		/*--------------------------+
+		|  debounce filter          |
+		+--------------------------*/
+		case M58_DEBOUNCE:
+			if (!IN_RANGE(value,0,0xff))
+				return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->dbCount[ch] = value;
+			CalcDebounce(llHdl);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		case M58_DEBOUNCE_MASK:
+			if (!IN_RANGE(value,0,0xff))
+				return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->dbChMask[ch] = value;
+			CalcDebounce(llHdl);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		/*--------------------------+
+		|  pulse counters           |
+		+--------------------------*/
+		case M58_CNT_RISE:
+		case M58_CNT_FALL:
+			/* newly read channels: no edges on first sample */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+			if (code == M58_CNT_RISE)
+				llHdl->cntRise = (u_int32)value;
+			else
+				llHdl->cntFall = (u_int32)value;
+
+			llHdl->cntValid = FALSE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		case M58_CNT_CLR:
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			OSS_MemFill(llHdl->osHdl, sizeof(llHdl->cnt),
+						(char*)llHdl->cnt, 0);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		/*--------------------------+
+		|  periodic sampling        |
+		+--------------------------*/
+		case M58_SMP_PERIOD:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			error = SetSamplePeriod(llHdl, value);
+			break;
+		/*--------------------------+
+		|  interrupt moderation     |
+		+--------------------------*/
+		case M58_MOD_THRESH:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->modThresh = value;
+			error = SetModeration(llHdl);
+			break;
+		case M58_MOD_PERIOD:
+			if (value < 1)
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->modPeriod = value;
+			error = SetModeration(llHdl);
+			break;
+		case M58_MOD_HOLD:
+			if (value < 1)
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->modHold = value;
+			break;
+		/*--------------------------+
+		|  signal coalescing        |
+		+--------------------------*/
+		case M58_SIG_EVERY:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->sigEvery = value;
+			break;
+		case M58_SIG_MINTIME:
+		{
+			/* usec per tick (round up interval to ticks) */
+			u_int32 tickUs = 1000000 / OSS_TickRateGet(llHdl->osHdl);
+
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			if (tickUs == 0)
+				tickUs = 1;
+
+			llHdl->sigMinTime  = value;
+			llHdl->sigMinTicks = (value + tickUs - 1) / tickUs;
+			break;
+		}
+		case M58_SIG_FILL:
+			if (value < 0)
+				return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->sigFill  = value;
+			llHdl->sigArmed = TRUE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		/*--------------------------+
+		|  capture window           |
+		+--------------------------*/
+		case M58_WIN_PRE:
+		case M58_WIN_POST:
+		case M58_WIN_MASK:
+		case M58_WIN_VALUE:
+			if (llHdl->winState == M58_WIN_ARMED ||
+				llHdl->winState == M58_WIN_FIRED)
+				return(ERR_LL_DEV_BUSY);
+
+			if (code == M58_WIN_MASK)
+				llHdl->winMask = (u_int32)value;
+			else if (code == M58_WIN_VALUE)
+				llHdl->winValue = (u_int32)value;
+			else {
+				if (value < (code == M58_WIN_POST ? 1 : 0) ||
+					(u_int32)value + (code == M58_WIN_PRE ? llHdl->winPost :
+									  llHdl->winPre) > llHdl->winDepth)
+					return(ERR_LL_ILL_PARAM);
+
+				if (code == M58_WIN_PRE)
+					llHdl->winPre = value;
+				else
+					llHdl->winPost = value;
+			}
+			break;
+		case M58_WIN_ARM:
+			if (!IN_RANGE(value,0,1))
+				return(ERR_LL_ILL_PARAM);
+
+			if (value && llHdl->winPost == 0)
+				return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->winState = value ? M58_WIN_ARMED : M58_WIN_IDLE;
+			llHdl->winMatch = TRUE;		/* wait for condition to become true */
+			llHdl->winIdx   = 0;
+			llHdl->winCount = 0;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		/*--------------------------+
+		|  pattern match            |
+		+--------------------------*/
+		case M58_MATCH_MODE:
+			if (!IN_RANGE(value,0,M58_MATCH_ALL))
+				return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->matMode = value;
+			llHdl->matLast = FALSE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		case M58_BLK_MATCH:
+		{
+			M58_MATCH *matP = (M58_MATCH*)blk->data;
+			u_int32 n, count = blk->size / sizeof(M58_MATCH);
+
+			if ((blk->size % sizeof(M58_MATCH)) || count > M58_MATCH_MAX)
+				return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->matBits = 0;
+
+			for (n=0; n<count; n++, matP++) {
+				llHdl->matMask[n]  = matP->mask;
+				llHdl->matValue[n] = matP->value;
+				llHdl->matBits    |= matP->mask;
+			}
+
+			llHdl->matCount = count;
+			llHdl->matLast  = FALSE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		/*--------------------------+
+		|  output bits              |
+		+--------------------------*/
+		case M58_OUT_SET_MASK:
+		case M58_OUT_CLR_MASK:
+		case M58_OUT_TOGGLE_MASK:
+		{
+			u_int32 image, mask = (u_int32)value;
+
+			if (mask & ~OutBits(llHdl))
+				return(ERR_LL_ILL_DIR);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			image = llHdl->outImage;
+
+			if (code == M58_OUT_SET_MASK)
+				image |= mask;
+			else if (code == M58_OUT_CLR_MASK)
+				image &= ~mask;
+			else
+				image ^= mask;
+
+			WriteOutputs(llHdl, image);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		/*--------------------------+
+		|  all ports                |
+		+--------------------------*/
+		case M58_PORTS_ALL:
+		{
+			u_int32 image = (u_int32)value;
+			int32 n;
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			for (n=0; n<CH_NUMBER; n++, image >>= 8)
+				if (llHdl->portDir[n] == PORT_DIR_OUT)
+					WritePort(llHdl, n, (u_int8)image);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		/*--------------------------+
+		|  id prom cache            |
+		+--------------------------*/
+		case M58_ID_REFRESH:
+			llHdl->idCache = TRUE;
+			ReadIdProm(llHdl);
+			break;
+		/*--------------------------+
+		|  reflex rules             |
+		+--------------------------*/
+		case M58_BLK_REFLEX:
+		{
+			M58_REFLEX *rflP = (M58_REFLEX*)blk->data;
+			u_int32 n, ch, count = blk->size / sizeof(M58_REFLEX);
+
+			if ((blk->size % sizeof(M58_REFLEX)) || count > M58_RFL_MAX)
+				return(ERR_LL_ILL_PARAM);
+
+			for (n=0; n<count; n++)
+				if (rflP[n].port >= CH_NUMBER ||
+					(rflP[n].action & ~M58_RFL_EDGE) > M58_RFL_WRITE)
+					return(ERR_LL_ILL_PARAM);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->rflBits = 0;
+
+			for (n=0; n<count; n++, rflP++) {
+				for (ch=0; ch<CH_NUMBER; ch++)
+					if (rflP->mask & ((u_int32)0xff << (ch * 8)))
+						llHdl->rflBits |= (u_int32)0xff << (ch * 8);
+
+				llHdl->rflMask[n]   = rflP->mask;
+				llHdl->rflValue[n]  = rflP->value;
+				llHdl->rflPort[n]   = rflP->port;
+				llHdl->rflAction[n] = rflP->action;
+				llHdl->rflData[n]   = rflP->data;
+				llHdl->rflHits[n]   = 0;
+			}
+
+			llHdl->rflCount = count;
+			llHdl->rflLast  = 0;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		/*--------------------------+
+		|  clear statistics         |
+		+--------------------------*/
+		case M58_STATS_CLR:
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->statTrig    = 0;
+			llHdl->statStored  = 0;
+			llHdl->statDropped = 0;
+			llHdl->statPartial = 0;
+			llHdl->statSigSent = 0;
+			llHdl->statFillMax = 0;
+			llHdl->smpMissed   = 0;
+			llHdl->statModPoll = 0;
+			llHdl->statBusD8   = 0;
+			llHdl->statBusD16  = 0;
+			llHdl->matHits     = 0;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		/*--------------------------+
+		|  MBUF + unknown           |
+		+--------------------------*/
+		default:
+			if (M_BUF_CODE(code)) {
+				/* event buffer can't be read directly */
+				if (llHdl->rdSource == M58_SRC_EVENTS) {
+					if (code == M_BUF_RD_MODE && value == M_BUF_USRCTRL)
+						return(ERR_LL_ILL_PARAM);
+
+					error = MBUF_SetStat(llHdl->evtBufHdl, llHdl->wrBufHdl,
+										 code, value);
+				}
+				else
+					error = MBUF_SetStat(llHdl->bufHdl, llHdl->wrBufHdl,
+										 code, value);
+
+				/* M58_Irq drains the output buffer in ring modes only */
+				if (!error && code == M_BUF_WR_MODE) {
+					irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+					llHdl->wrDrain = (value == M_BUF_RINGBUF ||
+									  value == M_BUF_RINGBUF_OVERWR);
+					OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+				}
+			}
+			else
+				error = ERR_LL_UNK_CODE;
+	}
+
+	return(error);
+}
+
+/****************************** M58_GetStat **********************************
+ *
+ *  Description:  Get driver status
+ *
+ *                Following status codes are supported:
+ *
+ *                Code                 Description                Values
+ *                -------------------  -------------------------  ----------
+ *                M_LL_DEBUG_LEVEL     driver debug level         see oss.h
+ *                M_LL_CH_NUMBER       number of channels         4
+ *                M_LL_CH_DIR          direction of curr chan     M_CH_IN,
+ *                                                                M_CH_OUT
+ *                M_LL_CH_LEN          length of curr chan [bits] 1..max
+ *                M_LL_CH_TYP          description of curr chan   M_CH_BINARY
+ *                M_LL_IRQ_COUNT       interrupt counter          0..max
+ *                M_LL_ID_CHECK        eeprom is checked          0..1
+ *                M_LL_ID_SIZE         eeprom size [bytes]        128
+ *                M_LL_BLK_ID_DATA     eeprom raw data            -
+ *                M_MK_BLK_REV_ID      ident function table ptr   -
+ *                M_BUF_xxx            in/output buffer codes     see MDIS
+ *                -------------------  -------------------------  ----------
+ *                M58_BUF_ENABLE       block i/o of curr chan     0..1
+ *                M58_PORT_TERM        termination of curr chan   0..1
+ *                M58_TRIG_EDGE        trigger edge               0..1
+ *                M58_DATA_MODE        data storage mode          0..7
+ *                M58_TRIG_SIG_SET     trigger signal code        0..max
+ *                M58_BUF_RDSIZE       nr of enabled input  chan. 0..4
+ *                M58_BUF_WRSIZE       nr of enabled output chan. 0..4
+ *                M58_BUF_RDCYCLES     bus cycles per input  frame 0..4
+ *                M58_BUF_WRCYCLES     bus cycles per output frame 0..4
+ *                M58_RD_SAMPLES       direct input frames/read   0..max
+ *                M58_RD_PACE          direct input period [usec] 0..max
+ *                M58_WR_PLAYBACK      block write playback mode  0..2
+ *                M58_WR_PACE          timed playback [usec]      0..max
+ *                M58_WR_TIMEOUT       trig. playback tout [msec] 0..max
+ *                M58_BUF_TSTAMP       timestamped input records  0..1
+ *                M58_BUF_RECSIZE      input buffer record size   0..12
+ *                M58_BUF_CAPTURE      input buffer capture mode  0..1
+ *                M58_CAPT_MASK        change detection mask      0..0xffffffff
+ *                M58_EVT_MASK         edge event mask            0..0xffffffff
+ *                M58_RD_SOURCE        block read source          0..2
+ *                M58_EVT_LOST         nr of lost edge events     0..max
+ *                M58_DEBOUNCE         debounce count of curr chan 0..255
+ *                M58_DEBOUNCE_MASK    debounce mask of curr chan 0..0xff
+ *                M58_CNT_RISE         rising  edge counter mask  0..0xffffffff
+ *                M58_CNT_FALL         falling edge counter mask  0..0xffffffff
+ *                M58_SMP_PERIOD       periodic sampling [msec]   0..max
+ *                M58_SMP_MISSED       missed sample periods      0..max
+ *                M58_MOD_THRESH       irq moderation threshold   0..max
+ *                M58_MOD_PERIOD       irq moderation poll [msec] 1..max
+ *                M58_MOD_HOLD         irq moderation hold        1..max
+ *                M58_MOD_POLLED       polled mode active         0..1
+ *                M58_SIG_EVERY        signal every n triggers    0..max
+ *                M58_SIG_MINTIME      min. signal interval[usec] 0..max
+ *                M58_SIG_FILL         signal fill threshold      0..max
+ *                M58_SIG_PENDING      triggers since last signal 0..max
+ *                M58_WIN_PRE          pre-trigger records        0..max
+ *                M58_WIN_POST         post-trigger records       0..max
+ *                M58_WIN_MASK         window arm condition mask  0..0xffffffff
+ *                M58_WIN_VALUE        window arm condition value 0..0xffffffff
+ *                M58_WIN_ARM          capture window state       0..3
+ *                M58_WIN_DEPTH        window history [records]   0..max
+ *                M58_MATCH_MODE       pattern match actions      0..7
+ *                M58_MATCH_HITS       pattern match hits         0..max
+ *                M58_PORTS_ALL        state of all channels      0..0xffffffff
+ *                -------------------  -------------------------  ----------
+ *                M58_BLK_STATS        statistics (M58_STATS)     -
+ *                M58_BLK_COUNTERS     pulse counters             -
+ *                M58_BLK_COUNTERS_CLR pulse counters, cleared    -
+ *                M58_BLK_WAIT_TRIG    wait for triggers (M58_WAIT) -
+ *                M58_BLK_MATCH        match table (M58_MATCH[])  -
+ *                M58_BLK_REFLEX       reflex rules (M58_REFLEX[]) -
+ *                M58_BLK_REFLEX_HITS  reflex rule hits (u_int32[]) -
+ *                M58_BLK_CMDLIST      execute command list       -
+ *                                     (M58_CMD[])
  *                -------------------  -------------------------  ----------
  *
  *                M_LL_CH_DIR returns  the direction of the current channel
  *                (see MDIS Doc.).
  *
+ *                M_LL_BLK_ID_DATA returns the id prom contents. If the id
+ *                prom cache is enabled (ID_CACHE descriptor key, see
+ *                M58_ID_REFRESH setstat), the cached data is returned
+ *                without accessing the id prom.
+ *
  *                M58_BUF_ENABLE returns if current channel is used with
  *                block i/o calls:
  *
@@ -956,6 +2301,164 @@ static int32 M58_SetStat(
  *                M58_BUF_WRSIZE returns the number of output channels where
  *                block i/o is enabled (minimum size for M58_BlockWrite).
  *
+ *                M58_BUF_RDCYCLES/M58_BUF_WRCYCLES return the number of port
+ *                bus cycles needed to read/write one frame of the enabled
+ *                input/output channels, i.e. the length of the read/write
+ *                plan. Adjacent ports A/B and C/D are accessed with one
+ *                D16 cycle, if both are enabled. The cycles actually
+ *                issued are counted in M58_BLK_STATS (busD8/busD16).
+ *
+ *                M58_RD_SAMPLES/M58_RD_PACE return the direct input
+ *                settings of M58_BlockRead (see M58_SetStat Function).
+ *
+ *                M58_WR_PLAYBACK/M58_WR_PACE/M58_WR_TIMEOUT return the
+ *                playback settings of M58_BlockWrite (see M58_SetStat
+ *                Function).
+ *
+ *                M58_BUF_TSTAMP returns the input buffer record format
+ *                (see M58_SetStat Function).
+ *
+ *                M58_BUF_RECSIZE returns the size of one input buffer
+ *                record in bytes (see M58_Irq Function).
+ *
+ *                M58_BUF_CAPTURE/M58_CAPT_MASK return the change-only
+ *                capture settings (see M58_SetStat Function).
+ *
+ *                M58_EVT_MASK/M58_RD_SOURCE return the edge event settings
+ *                (see M58_SetStat Function).
+ *
+ *                M58_EVT_LOST returns the number of edge events which could
+ *                not be stored, because the event buffer was full.
+ *
+ *                M58_DEBOUNCE/M58_DEBOUNCE_MASK return the debounce filter
+ *                settings of the current channel (see M58_SetStat Function).
+ *
+ *                M58_BLK_STATS returns a consistent snapshot of the
+ *                statistic counters (M58_STATS structure):
+ *
+ *                   trigCount   triggers seen (M58_Irq calls)
+ *                   stored      records stored into the input buffer
+ *                   dropped     records dropped (input buffer overrun)
+ *                   partial     records stored incompletely
+ *                   sigSent     trigger signals sent
+ *                   fillMax     max. input buffer fill level [bytes]
+ *                   modPoll     switches to polled mode (irq moderation)
+ *                   busD8       port D8 bus cycles issued
+ *                   busD16      port D16 bus cycles issued
+ *
+ *                The bus counters cover all port data accesses of block
+ *                i/o, M58_Irq, alarms, M58_Read/M58_Write and the output
+ *                mask setstats (not the control registers and id prom).
+ *
+ *                The counters can be cleared via M58_STATS_CLR setstat.
+ *
+ *                M58_CNT_RISE/M58_CNT_FALL return the pulse counter masks
+ *                (see M58_SetStat Function).
+ *
+ *                M58_SMP_PERIOD returns the real periodic sampling period
+ *                [msec] (0 = off).
+ *
+ *                M58_SMP_MISSED returns the number of sample periods missed,
+ *                because the alarm was executed late. It is cleared via the
+ *                M58_STATS_CLR setstat.
+ *
+ *                M58_MOD_THRESH/M58_MOD_PERIOD/M58_MOD_HOLD return the
+ *                interrupt moderation settings (see M58_SetStat Function).
+ *                M58_MOD_POLLED returns 1, if the driver is currently in
+ *                polled mode.
+ *
+ *                M58_SIG_EVERY/M58_SIG_MINTIME/M58_SIG_FILL return the
+ *                signal coalescing settings (see M58_SetStat Function).
+ *
+ *                M58_SIG_PENDING returns the number of triggers since the
+ *                last trigger signal was sent.
+ *
+ *                M58_WIN_PRE/M58_WIN_POST/M58_WIN_MASK/M58_WIN_VALUE return
+ *                the capture window settings (see M58_SetStat Function).
+ *                M58_WIN_ARM returns the capture window state:
+ *
+ *                   0 = disarmed or capture read (M58_WIN_IDLE)
+ *                   1 = armed, waiting for condition (M58_WIN_ARMED)
+ *                   2 = fired, recording post-trigger (M58_WIN_FIRED)
+ *                   3 = capture complete (M58_WIN_DONE)
+ *
+ *                M58_WIN_DEPTH returns the size of the window history
+ *                [records] (max. PRE+POST).
+ *
+ *                M58_MATCH_MODE returns the pattern match actions (see
+ *                M58_SetStat Function). M58_MATCH_HITS returns the number
+ *                of pattern match hits. It is cleared via the M58_STATS_CLR
+ *                setstat.
+ *
+ *                M58_BLK_MATCH returns the pattern match table (the block
+ *                size is set to the used table size).
+ *
+ *                M58_PORTS_ALL returns the state of all channels packed into
+ *                one 32-bit value (port A..D = bit 0..7, 8..15, 16..23,
+ *                24..31). Input channels are read from the module (like
+ *                M58_Read, incl. debounce filter), adjacent input ports
+ *                A/B or C/D with one D16 cycle. Output channels are taken
+ *                from the output shadow (last value written).
+ *
+ *                M58_BLK_REFLEX returns the reflex rules (the block size is
+ *                set to the used table size). M58_BLK_REFLEX_HITS returns a
+ *                consistent snapshot of the hit counters, one u_int32 per
+ *                rule (number of times the action was applied).
+ *
+ *                M58_BLK_CMDLIST executes a list of commands (M58_CMD
+ *                structures) in one call and writes the results back into
+ *                the list:
+ *
+ *                   op                 ch   arg          result
+ *                   -----------------  ---  -----------  ----------------
+ *                   M58_CMD_READ       in   -            value read
+ *                   M58_CMD_WRITE      out  value        value written
+ *                   M58_CMD_SETBITS    out  bits to set  value written
+ *                   M58_CMD_CLRBITS    out  bits to clr  value written
+ *                   M58_CMD_DELAY_US   -    delay [usec] -
+ *                   M58_CMD_WAIT_TRIG  -    tout [msec]  triggers seen
+ *
+ *                READ and WRITE behave like M58_Read and M58_Write.
+ *                SETBITS/CLRBITS modify the last value written to the
+ *                channel (output shadow) with interrupts masked, so they
+ *                do not lose concurrent reflex writes. DELAY_US busy-waits
+ *                and is limited to M58_CMD_DELAY_MAX usec (larger values
+ *                fail with ERR_LL_ILL_PARAM). The device stays locked for
+ *                the whole list, so the timing between the commands is
+ *                deterministic. M58_CMD_WAIT_TRIG releases the device while
+ *                waiting for the next trigger (see M58_BLK_WAIT_TRIG,
+ *                0 = no timeout) and is therefore only allowed as the last
+ *                command of the list. Otherwise the list is rejected with
+ *                ERR_LL_ILL_PARAM before any command is executed.
+ *
+ *                Execution stops at the first failing command and its
+ *                error code is returned. The block size is then set to
+ *                the size of the commands executed successfully.
+ *
+ *                M58_BLK_COUNTERS returns a consistent snapshot of the 32
+ *                pulse counters (M58_COUNTERS structure, count[n] = input
+ *                bit n). M58_BLK_COUNTERS_CLR additionally clears the
+ *                counters in the same atomic step, so that no edge is lost
+ *                between read and clear.
+ *
+ *                M58_BLK_WAIT_TRIG blocks the caller until a number of
+ *                triggers occurred or the input buffer reached a fill
+ *                level, whichever comes first (M58_WAIT structure):
+ *
+ *                   in : count      triggers to wait for
+ *                        fill       input buffer fill level [bytes]
+ *                                   (0 = don't care, count=fill=0 waits
+ *                                   for the next trigger)
+ *                        tout       timeout [msec] (0 = no timeout)
+ *                   out: trigCount  triggers seen (see M58_BLK_STATS)
+ *                        elapsed    time waited [msec]
+ *
+ *                The device is not locked while waiting, so other calls
+ *                (e.g. M58_BlockRead from another thread) are possible.
+ *                Only one caller can wait at a time, otherwise
+ *                ERR_LL_DEV_BUSY is returned. On timeout ERR_OSS_TIMEOUT
+ *                is returned and the out values are valid.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl             ll handle
  *                code              status code
@@ -1050,6 +2553,12 @@ static int32 M58_GetStat(
 			if (blk->size < MOD_ID_SIZE)		/* check buf size */
 				return(ERR_LL_USERBUF);
 
+			if (llHdl->idValid) {				/* take from cache */
+				for (n=0; n<MOD_ID_SIZE/2; n++)
+					*dataP++ = llHdl->idData[n];
+				break;
+			}
+
 			for (n=0; n<MOD_ID_SIZE/2; n++)		/* read MOD_ID_SIZE/2 words */
 				*dataP++ = (int16)m_read((U_INT32_OR_64)llHdl->ma, n);
 
@@ -1109,34 +2618,325 @@ static int32 M58_GetStat(
 			*valueP = llHdl->bufWrSize;
 			break;
 		/*--------------------------+
-		|  MBUF + unknown           |
+		|  bus cycles per frame     |
 		+--------------------------*/
-		default:
-			if (M_BUF_CODE(code))
-				error = MBUF_GetStat(llHdl->bufHdl, NULL, code, valueP);
-			else
-				error = ERR_LL_UNK_CODE;
-	}
-
-	return(error);
-}
-
-/******************************* M58_BlockRead *******************************
- *
- *  Description:  Read data block from device
- *
- *                Following block i/o modes are supported:
- *
- *                   M_BUF_USRCTRL         direct input
- *                   M_BUF_RINGBUF         buffered input
- *                   M_BUF_RINGBUF_OVERWR  buffered input
- *                   M_BUF_CURRBUF         buffered input
- *
- *                (Can be defined via M_BUF_RD_MODE setstat, see MDIS-Doc.)
- *
- *                Direct Input Mode
- *                -----------------
- *                For the M_BUF_USRCTRL mode, the function reads all input
+		case M58_BUF_RDCYCLES:
+			*valueP = llHdl->rdCycles;
+			break;
+		case M58_BUF_WRCYCLES:
+			*valueP = llHdl->wrCycles;
+			break;
+		/*--------------------------+
+		|  direct input settings    |
+		+--------------------------*/
+		case M58_RD_SAMPLES:
+			*valueP = llHdl->rdSamples;
+			break;
+		case M58_RD_PACE:
+			*valueP = llHdl->rdPace;
+			break;
+		/*--------------------------+
+		|  block write playback     |
+		+--------------------------*/
+		case M58_WR_PLAYBACK:
+			*valueP = llHdl->pbMode;
+			break;
+		case M58_WR_PACE:
+			*valueP = llHdl->pbPace;
+			break;
+		case M58_WR_TIMEOUT:
+			*valueP = llHdl->pbTout;
+			break;
+		/*--------------------------+
+		|  input record format      |
+		+--------------------------*/
+		case M58_BUF_TSTAMP:
+			*valueP = llHdl->tsEnable;
+			break;
+		case M58_BUF_RECSIZE:
+			*valueP = llHdl->recSize;
+			break;
+		/*--------------------------+
+		|  change-only capture      |
+		+--------------------------*/
+		case M58_BUF_CAPTURE:
+			*valueP = llHdl->captMode;
+			break;
+		case M58_CAPT_MASK:
+			*valueP = llHdl->captMask;
+			break;
+		/*--------------------------+
+		|  edge events              |
+		+--------------------------*/
+		case M58_EVT_MASK:
+			*valueP = llHdl->evtMask;
+			break;
+		case M58_RD_SOURCE:
+			*valueP = llHdl->rdSource;
+			break;
+		case M58_EVT_LOST:
+			*valueP = llHdl->evtLost;
+			break;
+		/*--------------------------+
+		|  debounce filter          |
+		+--------------------------*/
+		case M58_DEBOUNCE:
+			*valueP = llHdl->dbCount[ch];
+			break;
+		case M58_DEBOUNCE_MASK:
+			*valueP = llHdl->dbChMask[ch];
+			break;
+		/*--------------------------+
+		|  pulse counters           |
+		+--------------------------*/
+		case M58_CNT_RISE:
+			*valueP = llHdl->cntRise;
+			break;
+		case M58_CNT_FALL:
+			*valueP = llHdl->cntFall;
+			break;
+		/*--------------------------+
+		|  periodic sampling        |
+		+--------------------------*/
+		case M58_SMP_PERIOD:
+			*valueP = llHdl->smpPeriod;
+			break;
+		case M58_SMP_MISSED:
+			*valueP = llHdl->smpMissed;
+			break;
+		/*--------------------------+
+		|  interrupt moderation     |
+		+--------------------------*/
+		case M58_MOD_THRESH:
+			*valueP = llHdl->modThresh;
+			break;
+		case M58_MOD_PERIOD:
+			*valueP = llHdl->modPeriod;
+			break;
+		case M58_MOD_HOLD:
+			*valueP = llHdl->modHold;
+			break;
+		case M58_MOD_POLLED:
+			*valueP = llHdl->modLeft ? 1 : 0;
+			break;
+		/*--------------------------+
+		|  signal coalescing        |
+		+--------------------------*/
+		case M58_SIG_EVERY:
+			*valueP = llHdl->sigEvery;
+			break;
+		case M58_SIG_MINTIME:
+			*valueP = llHdl->sigMinTime;
+			break;
+		case M58_SIG_FILL:
+			*valueP = llHdl->sigFill;
+			break;
+		case M58_SIG_PENDING:
+			*valueP = llHdl->sigPend;
+			break;
+		/*--------------------------+
+		|  capture window           |
+		+--------------------------*/
+		case M58_WIN_PRE:
+			*valueP = llHdl->winPre;
+			break;
+		case M58_WIN_POST:
+			*valueP = llHdl->winPost;
+			break;
+		case M58_WIN_MASK:
+			*valueP = llHdl->winMask;
+			break;
+		case M58_WIN_VALUE:
+			*valueP = llHdl->winValue;
+			break;
+		case M58_WIN_ARM:
+			*valueP = llHdl->winState;
+			break;
+		case M58_WIN_DEPTH:
+			*valueP = llHdl->winDepth;
+			break;
+		/*--------------------------+
+		|  pattern match            |
+		+--------------------------*/
+		case M58_MATCH_MODE:
+			*valueP = llHdl->matMode;
+			break;
+		case M58_MATCH_HITS:
+			*valueP = llHdl->matHits;
+			break;
+		case M58_BLK_MATCH:
+		{
+			M58_MATCH *matP = (M58_MATCH*)blk->data;
+			OSS_IRQ_STATE irqState;
+			u_int32 n;
+
+			if (blk->size < (int32)(llHdl->matCount * sizeof(M58_MATCH)))
+				return(ERR_LL_USERBUF);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			for (n=0; n<llHdl->matCount; n++, matP++) {
+				matP->mask  = llHdl->matMask[n];
+				matP->value = llHdl->matValue[n];
+			}
+
+			blk->size = llHdl->matCount * sizeof(M58_MATCH);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			break;
+		}
+		/*--------------------------+
+		|  all ports                |
+		+--------------------------*/
+		case M58_PORTS_ALL:
+			*valueP = (int32)ReadInputs(llHdl);
+			break;
+		/*--------------------------+
+		|  reflex rules             |
+		+--------------------------*/
+		case M58_BLK_REFLEX:
+		{
+			M58_REFLEX *rflP = (M58_REFLEX*)blk->data;
+			u_int32 n;
+
+			if (blk->size < (int32)(llHdl->rflCount * sizeof(M58_REFLEX)))
+				return(ERR_LL_USERBUF);
+
+			/* rules are only changed under device semaphore */
+			for (n=0; n<llHdl->rflCount; n++, rflP++) {
+				rflP->mask   = llHdl->rflMask[n];
+				rflP->value  = llHdl->rflValue[n];
+				rflP->port   = llHdl->rflPort[n];
+				rflP->action = llHdl->rflAction[n];
+				rflP->data   = llHdl->rflData[n];
+				rflP->res    = 0;
+			}
+
+			blk->size = llHdl->rflCount * sizeof(M58_REFLEX);
+			break;
+		}
+		case M58_BLK_REFLEX_HITS:
+		{
+			u_int32 *hitsP = (u_int32*)blk->data;
+			OSS_IRQ_STATE irqState;
+			u_int32 n;
+
+			if (blk->size < (int32)(llHdl->rflCount * sizeof(u_int32)))
+				return(ERR_LL_USERBUF);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			for (n=0; n<llHdl->rflCount; n++)
+				hitsP[n] = llHdl->rflHits[n];
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+			blk->size = llHdl->rflCount * sizeof(u_int32);
+			break;
+		}
+		/*--------------------------+
+		|  command list             |
+		+--------------------------*/
+		case M58_BLK_CMDLIST:
+		{
+			u_int32 done;
+
+			if (blk->size % sizeof(M58_CMD))	/* check buf size */
+				return(ERR_LL_USERBUF);
+
+			error = CmdList(llHdl, (M58_CMD*)blk->data,
+							blk->size / sizeof(M58_CMD), &done);
+			blk->size = done * sizeof(M58_CMD);
+			break;
+		}
+		/*--------------------------+
+		|  statistics               |
+		+--------------------------*/
+		case M58_BLK_STATS:
+		{
+			M58_STATS *statsP = (M58_STATS*)blk->data;
+			OSS_IRQ_STATE irqState;
+
+			if (blk->size < (int32)sizeof(M58_STATS))	/* check buf size */
+				return(ERR_LL_USERBUF);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			statsP->trigCount = llHdl->statTrig;
+			statsP->stored    = llHdl->statStored;
+			statsP->dropped   = llHdl->statDropped;
+			statsP->partial   = llHdl->statPartial;
+			statsP->sigSent   = llHdl->statSigSent;
+			statsP->fillMax   = llHdl->statFillMax;
+			statsP->modPoll   = llHdl->statModPoll;
+			statsP->busD8     = llHdl->statBusD8;
+			statsP->busD16    = llHdl->statBusD16;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+			blk->size = sizeof(M58_STATS);
+			break;
+		}
+		/*--------------------------+
+		|  pulse counters           |
+		+--------------------------*/
+		case M58_BLK_COUNTERS:
+		case M58_BLK_COUNTERS_CLR:
+		{
+			M58_COUNTERS *cntP = (M58_COUNTERS*)blk->data;
+			OSS_IRQ_STATE irqState;
+			u_int32 n;
+
+			if (blk->size < (int32)sizeof(M58_COUNTERS))	/* check buf size */
+				return(ERR_LL_USERBUF);
+
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			for (n=0; n<CH_NUMBER*8; n++)
+				cntP->count[n] = llHdl->cnt[n];
+
+			if (code == M58_BLK_COUNTERS_CLR)
+				OSS_MemFill(llHdl->osHdl, sizeof(llHdl->cnt),
+							(char*)llHdl->cnt, 0);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+			blk->size = sizeof(M58_COUNTERS);
+			break;
+		}
+		/*--------------------------+
+		|  wait for triggers        |
+		+--------------------------*/
+		case M58_BLK_WAIT_TRIG:
+			if (blk->size < (int32)sizeof(M58_WAIT))	/* check buf size */
+				return(ERR_LL_USERBUF);
+
+			error = WaitTrig(llHdl, (M58_WAIT*)blk->data);
+			blk->size = sizeof(M58_WAIT);
+			break;
+		/*--------------------------+
+		|  MBUF + unknown           |
+		+--------------------------*/
+		default:
+			if (M_BUF_CODE(code))
+				error = MBUF_GetStat(llHdl->rdSource == M58_SRC_EVENTS ?
+									 llHdl->evtBufHdl : llHdl->bufHdl,
+									 llHdl->wrBufHdl, code, valueP);
+			else
+				error = ERR_LL_UNK_CODE;
+	}
+
+	return(error);
+}
+
+/******************************* M58_BlockRead *******************************
+ *
+ *  Description:  Read data block from device
+ *
+ *                Following block i/o modes are supported:
+ *
+ *                   M_BUF_USRCTRL         direct input
+ *                   M_BUF_RINGBUF         buffered input
+ *                   M_BUF_RINGBUF_OVERWR  buffered input
+ *                   M_BUF_CURRBUF         buffered input
+ *
+ *                (Can be defined via M_BUF_RD_MODE setstat, see MDIS-Doc.)
+ *
+ *                Direct Input Mode
+ *                -----------------
+ *                For the M_BUF_USRCTRL mode, the function reads all input
  *                channels, which are enabled for block i/o in ascending order
  *                into the given data buffer:
  *
@@ -1150,9 +2950,14 @@ static int32 M58_GetStat(
  *                   |  byte k |  last enabled input channel
  *                   +---------+
  *
- *                The maximum size which can be read depends on the number
- *                of enabled input channels and can be queried via the
- *                M58_BUF_RDSIZE getstat.
+ *                The frame size depends on the number of enabled input
+ *                channels and can be queried via the M58_BUF_RDSIZE getstat.
+ *
+ *                By default one frame is read. With the M58_RD_SAMPLES
+ *                setstat, the function samples several frames back-to-back
+ *                into the buffer (optionally paced via M58_RD_PACE). Only
+ *                complete frames are returned. Note that the device is
+ *                locked while sampling.
  *
  *                If no input channel is enabled ERR_LL_READ is returned.
  *
@@ -1185,6 +2990,27 @@ static int32 M58_GetStat(
  *                   mode=4: channel 1+2+3    latched when trigger occured
  *                   mode=5: channel 0+1+2+3  latched when trigger occured
  *
+ *                Edge Events
+ *                -----------
+ *                If the event buffer is selected (M58_RD_SOURCE), the
+ *                function copies requested number of bytes from the event
+ *                buffer, regardless of the input buffer mode.
+ *
+ *                Capture Window
+ *                --------------
+ *                If the capture window is selected (M58_RD_SOURCE), the
+ *                function returns the complete capture as one block of
+ *                records in chronological order (pre-trigger records, the
+ *                firing record, post-trigger records), regardless of the
+ *                input buffer mode. The size must be at least
+ *                (PRE+POST)*M58_BUF_RECSIZE bytes, otherwise ERR_LL_USERBUF
+ *                is returned. Less pre-trigger records are returned, if the
+ *                window fired before the history was filled.
+ *
+ *                If the capture is not complete yet (see M58_WIN_ARM
+ *                getstat), no data is returned (nbrRdBytes=0). After a
+ *                successful read, the window is disarmed.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl        ll handle
  *                ch           current channel
@@ -1203,12 +3029,21 @@ static int32 M58_BlockRead(
 )
 {
 	u_int8 *bufP = (u_int8*)buf;
-	u_int32 n;
+	u_int32 n, frames;
 	int32 bufMode;
 	int32 error;
+	OSS_IRQ_STATE irqState;
 
 	DBGWRT_1((DBH, "LL - M58_BlockRead: ch=%d, size=%d\n",ch,size));
 
+	/* read edge events ? */
+	if (llHdl->rdSource == M58_SRC_EVENTS)
+		return( MBUF_Read(llHdl->evtBufHdl, bufP, size, nbrRdBytesP) );
+
+	/* read capture window ? */
+	if (llHdl->rdSource == M58_SRC_WINDOW)
+		return( WindowRead(llHdl, bufP, size, nbrRdBytesP) );
+
 	/* get current buffer mode */
 	if ((error = MBUF_GetBufferMode(llHdl->bufHdl, &bufMode)))
 		return(error);
@@ -1225,12 +3060,26 @@ static int32 M58_BlockRead(
 		if (size < llHdl->bufRdSize)
 			return(ERR_LL_USERBUF);
 
+		/* nr of frames to read */
+		frames = size / llHdl->bufRdSize;
+
+		if (llHdl->rdSamples && (llHdl->rdSamples < frames))
+			frames = llHdl->rdSamples;
+
 		/* read port A..D */
-		for (n=0; n<CH_NUMBER; n++)
-			if (llHdl->bufEnable[n] && (llHdl->portDir[n] == PORT_DIR_IN))
-				*bufP++ = MREAD_D8(llHdl->ma, llHdl->portReg[n]);
+		for (n=0; n<frames; n++) {
+			if (n && llHdl->rdPace)
+				OSS_MikroDelay(llHdl->osHdl, llHdl->rdPace);
 
-		*nbrRdBytesP = (u_int32)(bufP - (u_int8*)buf);
+			/* debounce filter and bus counters are shared with M58_Irq */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			ReadFrame(llHdl, bufP);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+			bufP += llHdl->bufRdSize;
+		}
+
+		*nbrRdBytesP = (int32)(bufP - (u_int8*)buf);
 	}
 	/*-------------------------+
 	| read from input buffer   |
@@ -1250,12 +3099,14 @@ static int32 M58_BlockRead(
  *
  *                Following block i/o modes are supported:
  *
- *                   M_BUF_USRCTRL         direct input
+ *                   M_BUF_USRCTRL         direct output
+ *                   M_BUF_RINGBUF         buffered output
+ *                   M_BUF_RINGBUF_OVERWR  buffered output
  *
  *                (Can be defined via M_BUF_WR_MODE setstat, see MDIS-Doc.)
  *
- *                Direct Input Mode
- *                -----------------
+ *                Direct Output Mode
+ *                ------------------
  *                The function writes the values from the given buffer to
  *                all output channels, which are enabled for block i/o in
  *                ascending order:
@@ -1270,12 +3121,46 @@ static int32 M58_BlockRead(
  *                   |  byte k |  last enabled output channel
  *                   +---------+
  *
- *                The maximum size which can be written depends on the number
- *                of enabled output channels and can be queried via the
- *                M58_BUF_WRSIZE getstat.
+ *                The frame size depends on the number of enabled output
+ *                channels and can be queried via the M58_BUF_WRSIZE getstat.
+ *
+ *                The M58_WR_PLAYBACK setstat defines how many frames
+ *                are written:
+ *
+ *                   M58_PB_SINGLE: The first frame of the buffer is written.
+ *
+ *                   M58_PB_TIMED:  All complete frames of the buffer are
+ *                                  written back-to-back, with a delay of
+ *                                  M58_WR_PACE [usec] between two frames.
+ *                                  Note that the device is locked while
+ *                                  writing.
+ *
+ *                   M58_PB_TRIG:   All complete frames of the buffer are
+ *                                  written by M58_Irq, one frame per
+ *                                  trigger edge (the interrupt must be
+ *                                  enabled). The function waits until all
+ *                                  frames are written or M58_WR_TIMEOUT
+ *                                  expired. On timeout, the playback is
+ *                                  stopped and ERR_OSS_TIMEOUT is returned.
+ *                                  While running, the frame size cannot
+ *                                  be changed (see M58_SetStat).
+ *
+ *                The number of bytes consumed from the buffer is returned.
  *
  *                If no output channel is enabled ERR_LL_WRITE is returned.
  *
+ *                Buffered Output Mode
+ *                --------------------
+ *                For the buffered modes, the function copies the given
+ *                data buffer into the output buffer. M58_Irq takes one
+ *                frame (see above) from the output buffer per trigger edge
+ *                and writes it to the enabled output channels, so that
+ *                the outputs are updated synchronously to the trigger.
+ *                (see also function M58_Irq)
+ *
+ *                For details on buffered output modes (timeout, lowwater
+ *                event) refer to the MDIS-Doc.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl        ll handle
  *                ch           current channel
@@ -1294,10 +3179,21 @@ static int32 M58_BlockWrite(
 )
 {
 	u_int8 *bufP = (u_int8*)buf;
-	u_int32 n;
+	int32 n, frames, bufMode, error;
+	OSS_IRQ_STATE irqState;
 
 	DBGWRT_1((DBH, "LL - M58_BlockWrite: ch=%d, size=%d\n",ch,size));
 
+	/* get current buffer mode */
+	if ((error = MBUF_GetBufferMode(llHdl->wrBufHdl, &bufMode)))
+		return(error);
+
+	/*-------------------------+
+	| write to output buffer   |
+	+-------------------------*/
+	if (bufMode != M_BUF_USRCTRL)
+		return( MBUF_Write(llHdl->wrBufHdl, bufP, size, nbrWrBytesP) );
+
 	/* check if any channel to write */
 	if (llHdl->bufWrSize == 0)
 		return(ERR_LL_WRITE);
@@ -1306,12 +3202,70 @@ static int32 M58_BlockWrite(
 	if (size < llHdl->bufWrSize)
 		return(ERR_LL_USERBUF);
 
-	/*-------------------------+
-	| write to  hardware       |
-	+-------------------------*/
-	for (n=0; n<CH_NUMBER; n++)
-		if (llHdl->bufEnable[n] && (llHdl->portDir[n] == PORT_DIR_OUT))
-			MWRITE_D8(llHdl->ma, llHdl->portReg[n], *bufP++);
+	/* nr of frames to write */
+	frames = size / llHdl->bufWrSize;
+
+	switch (llHdl->pbMode) {
+		/*-------------------------+
+		| write one frame          |
+		+-------------------------*/
+		case M58_PB_SINGLE:
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			WriteFrame(llHdl, bufP);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+			bufP += llHdl->bufWrSize;
+			break;
+		/*-------------------------+
+		| timed playback           |
+		+-------------------------*/
+		case M58_PB_TIMED:
+			for (n=0; n<frames; n++) {
+				if (n && llHdl->pbPace)
+					OSS_MikroDelay(llHdl->osHdl, llHdl->pbPace);
+
+				/* output shadow is shared with M58_Irq */
+				irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+				WriteFrame(llHdl, bufP);
+				OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+				bufP += llHdl->bufWrSize;
+			}
+			break;
+		/*-------------------------+
+		| triggered playback       |
+		+-------------------------*/
+		case M58_PB_TRIG:
+			/* playback of another caller running ? */
+			if (llHdl->pbLeft)
+				return(ERR_LL_DEV_BUSY);
+
+			llHdl->pbBufP = bufP;
+			llHdl->pbLeft = frames;
+
+			/* wait until done (release device semaphore meanwhile) */
+			OSS_SemSignal(llHdl->osHdl, llHdl->devSemHdl);
+			error = OSS_SemWait(llHdl->osHdl, llHdl->pbSem,
+								llHdl->pbTout ? (int32)llHdl->pbTout :
+								OSS_SEM_WAITFOREVER);
+			OSS_SemWait(llHdl->osHdl, llHdl->devSemHdl, OSS_SEM_WAITFOREVER);
+
+			/* stop playback */
+			irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			if (error && llHdl->pbLeft == 0) {
+				/* done just after timeout: take late signal */
+				OSS_SemWait(llHdl->osHdl, llHdl->pbSem, 0);
+				error = ERR_SUCCESS;
+			}
+			bufP += (frames - llHdl->pbLeft) * llHdl->bufWrSize;
+			llHdl->pbLeft = 0;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+			if (error) {
+				DBGWRT_ERR((DBH, " *** M58_BlockWrite: playback timeout\n"));
+				*nbrWrBytesP = (int32)(bufP - (u_int8*)buf);
+				return(error);
+			}
+			break;
+	}
 
 	/* return nr of written bytes */
 	*nbrWrBytesP = (int32)(bufP - (u_int8*)buf);
@@ -1341,6 +3295,88 @@ static int32 M58_BlockWrite(
  *                   |  byte k |  last enabled input channel
  *                   +---------+
  *
+ *                If timestamped records are enabled (M58_BUF_TSTAMP), each
+ *                frame is stored as fixed size record (M58_TS_REC):
+ *
+ *                   +---------+
+ *                   | tick    |  OSS tick at irq entry (u_int32)
+ *                   +---------+
+ *                   | seq     |  trigger sequence number (u_int32)
+ *                   +---------+
+ *                   | data[4] |  frame as above, unused bytes are zero
+ *                   +---------+
+ *
+ *                The trigger sequence number is incremented on each
+ *                trigger, so that dropped records can be detected.
+ *
+ *                In change-only capture mode (M58_BUF_CAPTURE), a record is
+ *                only stored if at least one input bit of M58_CAPT_MASK
+ *                differs from the last stored record. Timestamped records
+ *                are always used in this mode, the difference of two
+ *                sequence numbers is the number of triggers the first
+ *                frame was repeated.
+ *
+ *                If edge events are enabled (M58_EVT_MASK), each input bit
+ *                of the mask which toggled since the previous trigger is
+ *                stored as event record (M58_EVT_REC) into the event buffer,
+ *                in ascending bit order:
+ *
+ *                   +---------+
+ *                   | tick    |  OSS tick at irq entry (u_int32)
+ *                   +---------+
+ *                   | seq     |  trigger sequence number (u_int32)
+ *                   +---------+
+ *                   | bit     |  input bit 0..31 (u_int8)
+ *                   +---------+
+ *                   | edge    |  M58_EDGE_FALL/M58_EDGE_RISE (u_int8)
+ *                   +---------+
+ *                   | res[2]  |  reserved (zero)
+ *                   +---------+
+ *
+ *                No events are generated for the first trigger after the
+ *                mask or the enabled input channels have been changed.
+ *
+ *                If pulse counters are enabled (M58_CNT_RISE/M58_CNT_FALL),
+ *                the counter of each input bit with a selected edge since
+ *                the previous trigger is incremented.
+ *
+ *                If reflex rules are loaded (M58_BLK_REFLEX), they are
+ *                evaluated first, right after the inputs were read, so that
+ *                the outputs react within the interrupt latency. Outputs
+ *                written from the output buffer afterwards (see below)
+ *                overwrite reflex actions on the same channel.
+ *
+ *                The input handling above is also done periodically
+ *                without trigger, if periodic sampling is enabled (see
+ *                M58_SMP_PERIOD).
+ *
+ *                A caller waiting via M58_BLK_WAIT_TRIG is woken up, if its
+ *                trigger count or fill level is reached.
+ *
+ *                If pattern matching is enabled (M58_MATCH_MODE), frames
+ *                and/or the trigger signal are suppressed unless the sample
+ *                hits the match table.
+ *
+ *                If a trigger signal is installed, it is sent according to
+ *                the signal coalescing settings (see M58_SIG_xxx).
+ *
+ *                If interrupt moderation is enabled (M58_MOD_THRESH) and
+ *                the trigger rate exceeds the threshold, the interrupt is
+ *                disabled and the inputs are polled (see ModAlarm).
+ *
+ *                The whole record is reserved with one MBUF_GetNextBuf call
+ *                and committed with one MBUF_ReadyBuf call. If the record
+ *                does not fit completely into the buffer, it is dropped,
+ *                so that no partial records are stored.
+ *
+ *                If a triggered playback is running (see M58_BlockWrite),
+ *                the next playback frame is written to the output channels.
+ *                Otherwise, if the output buffer is used in a ring buffer
+ *                mode (M_BUF_RINGBUF, M_BUF_RINGBUF_OVERWR), the next frame
+ *                is taken from the output buffer and written to the output
+ *                channels, which are enabled for block i/o. If the buffer
+ *                holds less than one frame, the outputs are not changed.
+ *
  *                If trigger signal is enabled, the defined signal is send
  *                to the user process.
  *
@@ -1355,12 +3391,16 @@ static int32 M58_Irq(
 	LL_HANDLE *llHdl
 )
 {
-	int32 n, got;
+	int32 got;
+	u_int32 tick = 0;
 	u_int16 dummy;
 	u_int8 *bufP;
 
 	IDBGWRT_1((DBH, ">>> M58_Irq:\n"));
 
+	if (llHdl->recTs || llHdl->evtMask || llHdl->sigMinTicks)
+		tick = OSS_TickGet(llHdl->osHdl);
+
 	/*----------------------+
 	| reset irq             |
 	+----------------------*/
@@ -1369,25 +3409,83 @@ static int32 M58_Irq(
 	/*----------------------+
 	| fill buffer           |
 	+----------------------*/
-	for (n=0; n<CH_NUMBER; n++){
-		if (llHdl->bufEnable[n] && (llHdl->portDir[n] == PORT_DIR_IN)) {
-			/* get buffer ptr - overrun ? */
-			if ((bufP = (u_int8*)MBUF_GetNextBuf(llHdl->bufHdl, 1, &got)) == NULL)
-				break;
+	Sample(llHdl, tick);
+
+	llHdl->statTrig++;
+
+	/*----------------------+
+	| wake up waiter        |
+	+----------------------*/
+	if (llHdl->waitActive) {
+		if (llHdl->waitLeft)
+			llHdl->waitLeft--;
+
+		/* (fill level is checked by Sample) */
+		if (llHdl->waitLeft == 0) {
+			llHdl->waitActive = FALSE;
+			OSS_SemSignal(llHdl->osHdl, llHdl->waitSem);
+		}
+	}
+
+	/*----------------------+
+	| irq moderation        |
+	+----------------------*/
+	if (llHdl->modThresh && ++llHdl->modCount > llHdl->modThresh &&
+		llHdl->modLeft == 0) {
+		/* trigger storm: disable irq, ModAlarm polls */
+		llHdl->ctrl3 &= ~IEN;
+		MWRITE_D16(llHdl->ma, CTRL3_REG, llHdl->ctrl3);
+
+		llHdl->modLeft = llHdl->modHold;
+		llHdl->statModPoll++;
+		IDBGWRT_2((DBH, " M58_Irq: polled mode\n"));
+	}
 
-			/* fill buffer entry */
-			*bufP = MREAD_D8(llHdl->ma, llHdl->portReg[n]);
+	/*----------------------+
+	| playback output frame |
+	+----------------------*/
+	if (llHdl->pbLeft) {
+		WriteFrame(llHdl, llHdl->pbBufP);
+		llHdl->pbBufP += llHdl->bufWrSize;
 
-			/* say: buffer written */
-			MBUF_ReadyBuf(llHdl->bufHdl);
+		/* say: playback done */
+		if (--llHdl->pbLeft == 0)
+			OSS_SemSignal(llHdl->osHdl, llHdl->pbSem);
+	}
+	/*----------------------+
+	| drain output buffer   |
+	+----------------------*/
+	else if (llHdl->wrDrain && llHdl->bufWrSize) {
+		/* get buffer ptr for whole frame - underrun ? */
+		if ((bufP = (u_int8*)MBUF_GetNextBuf(llHdl->wrBufHdl,
+											 llHdl->bufWrSize, &got)) != NULL) {
+			if (got == llHdl->bufWrSize) {
+				/* write output channels */
+				WriteFrame(llHdl, bufP);
+
+				/* say: buffer read */
+				MBUF_ReadyBuf(llHdl->wrBufHdl);
+			}
+			else {
+				/* frame split at buffer end (or buffer nearly empty) */
+				WriteSplitFrame(llHdl, bufP, got);
+			}
 		}
 	}
 
 	/*----------------------+
 	| send signal           |
 	+----------------------*/
-	if (llHdl->sigHdl)
+	llHdl->sigPend++;
+
+	if (llHdl->sigHdl &&
+		(!(llHdl->matMode & M58_MATCH_SIG) || llHdl->matHit) &&
+		SigDue(llHdl, tick)) {
 		OSS_SigSend(llHdl->osHdl, llHdl->sigHdl);
+		llHdl->statSigSent++;
+		llHdl->sigPend = 0;
+		llHdl->sigLast = tick;
+	}
 
 	llHdl->irqCount++;
 
@@ -1556,20 +3654,52 @@ static int32 Cleanup(
 	if (llHdl->descHdl)
 		DESC_Exit(&llHdl->descHdl);
 
-	/* clean up buffer */
+	/* clean up alarms (before buffers, the alarms store into them) */
+	if (llHdl->alarmHdl) {
+		if (llHdl->smpPeriod)
+			OSS_AlarmClear(llHdl->osHdl, llHdl->alarmHdl);
+
+		OSS_AlarmRemove(llHdl->osHdl, &llHdl->alarmHdl);
+	}
+
+	if (llHdl->modAlarmHdl) {
+		if (llHdl->modActive)
+			OSS_AlarmClear(llHdl->osHdl, llHdl->modAlarmHdl);
+
+		OSS_AlarmRemove(llHdl->osHdl, &llHdl->modAlarmHdl);
+	}
+
+	/* clean up buffers */
 	if (llHdl->bufHdl)
 		MBUF_Remove(&llHdl->bufHdl);
 
+	if (llHdl->wrBufHdl)
+		MBUF_Remove(&llHdl->wrBufHdl);
+
+	if (llHdl->evtBufHdl)
+		MBUF_Remove(&llHdl->evtBufHdl);
+
 	/* clean up signal */
 	if (llHdl->sigHdl)
 		OSS_SigRemove(llHdl->osHdl, &llHdl->sigHdl);
 
+	/* clean up semaphore */
+	if (llHdl->pbSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->pbSem);
+
+	if (llHdl->waitSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->waitSem);
+
 	/* cleanup debug */
 	DBGEXIT((&DBH));
 
 	/*------------------------------+
 	|  free memory                  |
 	+------------------------------*/
+	/* free capture window history */
+	if (llHdl->winBuf)
+		OSS_MemFree(llHdl->osHdl, (int8*)llHdl->winBuf, llHdl->winAlloc);
+
 	/* free my handle */
 	OSS_MemFree(llHdl->osHdl, (int8*)llHdl, llHdl->memAlloc);
 
@@ -1584,6 +3714,20 @@ static int32 Cleanup(
  *  Description: Calculates the buffer size for all enabled channels
  *               with matching port direction.
  *
+ *               The bus cycles for these channels are stored in ascending
+ *               channel order in the read or write plan (rdPlan/wrPlan),
+ *               which is used by the block i/o and interrupt functions.
+ *               If both ports of a pair (A/B or C/D) are used, the pair
+ *               is accessed with one D16 cycle.
+ *
+ *               For the input direction, the input buffer record size
+ *               and layout are updated too. Timestamped records are used
+ *               if enabled or if change-only capture is active. The
+ *               capture window is disarmed.
+ *
+ *               Once the interrupt is installed, the caller must mask it,
+ *               since M58_Irq and the alarm routines walk the plans.
+ *
  *---------------------------------------------------------------------------
  *  Input......: llHdl      ll handle
  *               portDir    port direction (PORT_DIR_xxx)
@@ -1595,17 +3739,1578 @@ static u_int32 CalcBufSize(
 	u_int32   portDir     /* nodoc */
 )
 {
-	u_int32 n, size;
+	static const u_int8 pairReg[CH_NUMBER/2] = { PORTAB_REG, PORTCD_REG };
+	PLAN_ENTRY *planP = (portDir == PORT_DIR_IN) ? llHdl->rdPlan : llHdl->wrPlan;
+	u_int32 n, size, lo, hi, bits;
+	int32 cycles;
+
+	for (size=0, cycles=0, bits=0, n=0; n<CH_NUMBER; n+=2) {
+		lo = llHdl->bufEnable[n]   && (llHdl->portDir[n]   == portDir);
+		hi = llHdl->bufEnable[n+1] && (llHdl->portDir[n+1] == portDir);
+
+		if (lo && hi) {
+			planP[cycles].reg   = pairReg[n/2];
+			planP[cycles].shift = (u_int8)(n * 8);
+			planP[cycles++].d16 = TRUE;
+		}
+		else if (lo || hi) {
+			planP[cycles].reg   = llHdl->portReg[lo ? n : n+1];
+			planP[cycles].shift = (u_int8)((lo ? n : n+1) * 8);
+			planP[cycles++].d16 = FALSE;
+		}
+
+		size += lo + hi;
+		bits |= (lo ? (u_int32)0xff << (n*8)   : 0) |
+				(hi ? (u_int32)0xff << (n*8+8) : 0);
+	}
 
-	for (size=0, n=0; n<CH_NUMBER; n++)
-		if (llHdl->bufEnable[n] && (llHdl->portDir[n] == portDir))
-			size++;
+	if (portDir == PORT_DIR_IN) {
+		llHdl->rdCycles = cycles;
+		llHdl->rdBits   = bits;
+		llHdl->recTs    = size &&
+			(llHdl->tsEnable || llHdl->captMode == M58_CAPT_CHANGE);
+		llHdl->recSize  = llHdl->recTs ? (int32)sizeof(M58_TS_REC) : (int32)size;
+		llHdl->captValid = FALSE;
+		llHdl->evtValid  = FALSE;
+		llHdl->cntValid  = FALSE;
+		llHdl->winState  = M58_WIN_IDLE;		/* record size changed */
+	}
+	else
+		llHdl->wrCycles = cycles;
 
-	DBGWRT_1((DBH," buf%sSize=%d\n",portDir ? "Rd":"Wr",size));
+	DBGWRT_1((DBH," buf%sSize=%d cycles=%d\n",portDir ? "Rd":"Wr",size,cycles));
 
 	return(size);
 }
 
+/********************************* ReadFrame ********************************
+ *
+ *  Description: Read all input channels, which are enabled for block i/o,
+ *               in ascending order into the given frame buffer.
+ *
+ *               The channels are taken from the read plan (see CalcBufSize)
+ *               without checking direction or enable flags.
+ *
+ *               Additionally, the frame is returned as 32-bit input image
+ *               (port A..D = bit 0..7, 8..15, 16..23, 24..31). Bits of
+ *               channels not read are zero.
+ *
+ *               If the debounce filter is enabled, the frame and the input
+ *               image contain the filtered values.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               bufP       frame buffer (bufRdSize bytes)
+ *  Output.....: return     input image
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 ReadFrame(
+	LL_HANDLE *llHdl,
+	u_int8    *bufP     /* nodoc */
+)
+{
+	PLAN_ENTRY *planP = llHdl->rdPlan;
+	u_int8 *frameP = bufP;
+	u_int32 in = 0;
+	int32 n;
+
+	/* unrolled walk over read plan (ascending channel order) */
+	switch (llHdl->rdCycles) {
+		case 4:	bufP = ReadPlanEntry(llHdl, planP++, bufP, &in);	/* fall through */
+		case 3:	bufP = ReadPlanEntry(llHdl, planP++, bufP, &in);	/* fall through */
+		case 2:	bufP = ReadPlanEntry(llHdl, planP++, bufP, &in);	/* fall through */
+		case 1:	ReadPlanEntry(llHdl, planP, bufP, &in);
+	}
+
+	/* debounce filter: rewrite frame with filtered values */
+	if (llHdl->dbMask) {
+		in = Debounce(llHdl, in, llHdl->rdBits);
+
+		for (planP=llHdl->rdPlan, n=0; n<llHdl->rdCycles; n++, planP++) {
+			*frameP++ = (u_int8)(in >> planP->shift);
+
+			if (planP->d16)
+				*frameP++ = (u_int8)(in >> (planP->shift + 8));
+		}
+	}
+
+	return(in);
+}
+
+/********************************* WriteFrame *******************************
+ *
+ *  Description: Write the given frame buffer in ascending order to all
+ *               output channels, which are enabled for block i/o.
+ *
+ *               The channels are taken from the write plan (see CalcBufSize)
+ *               without checking direction or enable flags.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               bufP       frame buffer (bufWrSize bytes)
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void WriteFrame(
+	LL_HANDLE *llHdl,
+	u_int8    *bufP     /* nodoc */
+)
+{
+	PLAN_ENTRY *planP = llHdl->wrPlan;
+
+	/* unrolled walk over write plan (ascending channel order) */
+	switch (llHdl->wrCycles) {
+		case 4:	bufP = WritePlanEntry(llHdl, planP++, bufP);	/* fall through */
+		case 3:	bufP = WritePlanEntry(llHdl, planP++, bufP);	/* fall through */
+		case 2:	bufP = WritePlanEntry(llHdl, planP++, bufP);	/* fall through */
+		case 1:	WritePlanEntry(llHdl, planP, bufP);
+	}
+}
+
+/******************************* ReadPlanEntry ******************************
+ *
+ *  Description: Execute one bus cycle of the read plan.
+ *
+ *               A D16 cycle stores the low byte (port A/C) first and the
+ *               high byte (port B/D) second.
+ *
+ *               The value read is also merged into the input image.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               planP      plan entry
+ *               bufP       frame buffer position
+ *               inP        input image
+ *  Output.....: return     next frame buffer position
+ *               *inP       updated input image
+ *  Globals....: -
+ ****************************************************************************/
+static u_int8* ReadPlanEntry(
+	LL_HANDLE  *llHdl,
+	PLAN_ENTRY *planP,
+	u_int8     *bufP,
+	u_int32    *inP      /* nodoc */
+)
+{
+	u_int16 word;
+
+	if (planP->d16) {
+		word = MREAD_D16(llHdl->ma, planP->reg);
+		*bufP++ = (u_int8)(word & 0xff);
+		*bufP++ = (u_int8)(word >> 8);
+		llHdl->statBusD16++;
+	}
+	else {
+		word = MREAD_D8(llHdl->ma, planP->reg);
+		*bufP++ = (u_int8)word;
+		llHdl->statBusD8++;
+	}
+
+	*inP |= (u_int32)word << planP->shift;
+
+	return(bufP);
+}
+
+/******************************* WritePlanEntry *****************************
+ *
+ *  Description: Execute one bus cycle of the write plan.
+ *
+ *               A D16 cycle takes the low byte (port A/C) first and the
+ *               high byte (port B/D) second from the frame buffer.
+ *
+ *               The value written is also merged into the output shadow.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               planP      plan entry
+ *               bufP       frame buffer position
+ *  Output.....: return     next frame buffer position
+ *  Globals....: -
+ ****************************************************************************/
+static u_int8* WritePlanEntry(
+	LL_HANDLE  *llHdl,
+	PLAN_ENTRY *planP,
+	u_int8     *bufP     /* nodoc */
+)
+{
+	u_int32 word, bits;
+
+	if (planP->d16) {
+		word = bufP[0] | (bufP[1] << 8);
+		bits = 0xffff;
+		MWRITE_D16(llHdl->ma, planP->reg, (u_int16)word);
+		bufP += 2;
+		llHdl->statBusD16++;
+	}
+	else {
+		word = *bufP++;
+		bits = 0xff;
+		MWRITE_D8(llHdl->ma, planP->reg, (u_int8)word);
+		llHdl->statBusD8++;
+	}
+
+	/* update output shadow */
+	llHdl->outImage = (llHdl->outImage & ~(bits << planP->shift)) |
+					  (word << planP->shift);
+
+	return(bufP);
+}
+
+/******************************** FillRecord ********************************
+ *
+ *  Description: Read all input channels, which are enabled for block i/o,
+ *               into an input buffer record (called from M58_Irq).
+ *
+ *               The record is either the raw frame or, if timestamped
+ *               records are used (see CalcBufSize), a M58_TS_REC structure.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               recP       record buffer (M58_TS_REC aligned)
+ *               tick       OSS tick at irq entry
+ *  Output.....: return     input image (see ReadFrame)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 FillRecord(
+	LL_HANDLE *llHdl,
+	u_int8    *recP,
+	u_int32   tick      /* nodoc */
+)
+{
+	M58_TS_REC *tsRecP = (M58_TS_REC*)recP;
+
+	if (!llHdl->recTs)
+		return(ReadFrame(llHdl, recP));
+
+	tsRecP->tick = tick;
+	tsRecP->seq  = llHdl->tsSeq;
+	tsRecP->data[0] = tsRecP->data[1] = tsRecP->data[2] = tsRecP->data[3] = 0;
+
+	return(ReadFrame(llHdl, tsRecP->data));
+}
+
+/********************************** Sample **********************************
+ *
+ *  Description: Take one sample of the input channels (called from M58_Irq
+ *               and SampleAlarm).
+ *
+ *               Channels used by the reflex rules, the pattern match, the
+ *               edge events or the pulse counters, but missing in the
+ *               frame, are read in addition (also without input buffer).
+ *               The reflex rules are applied first. The inputs are
+ *               checked against the pattern match table (the result is
+ *               kept in matHit for M58_Irq), the frame is stored into the
+ *               input buffer (honouring the match and change-only capture
+ *               modes) and passed to the capture window, then the inputs
+ *               are passed to the edge event queue and the pulse
+ *               counters. The trigger sequence
+ *               number is incremented.
+ *
+ *               A M58_BLK_WAIT_TRIG caller waiting for a fill level is
+ *               woken up here, so that periodic and polled samples wake
+ *               it too (the trigger count is handled by M58_Irq).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               tick       OSS tick of sample
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Sample(
+	LL_HANDLE *llHdl,
+	u_int32   tick      /* nodoc */
+)
+{
+	u_int32 in = 0, all, bits, match;
+	int32 bufCount;
+	M58_TS_REC rec;		/* (raw frame or timestamped record) */
+
+	llHdl->matHit = FALSE;
+
+	if (llHdl->recSize)
+		in = FillRecord(llHdl, (u_int8*)&rec, tick);
+
+	/* channels of reflex rules, match, events and counters not in frame */
+	bits = ChanBits((llHdl->rflCount ? llHdl->rflBits : 0) |
+					(llHdl->matMode ? llHdl->matBits : 0) |
+					llHdl->evtMask | llHdl->cntRise | llHdl->cntFall) &
+		   ~llHdl->rdBits;
+	all  = bits ? in | ReadPorts(llHdl, bits) : in;
+
+	/* reflex rules (first, for minimum latency) */
+	if (llHdl->rflCount)
+		Reflex(llHdl, all);
+
+	/* pattern match: hit on match or transition into match */
+	if (llHdl->matMode) {
+		match = MatchTable(llHdl, all);
+
+		llHdl->matHit = match && (!(llHdl->matMode & M58_MATCH_EDGE) ||
+								  !llHdl->matLast);
+		llHdl->matLast = match;
+
+		if (llHdl->matHit)
+			llHdl->matHits++;
+	}
+
+	if (llHdl->recSize) {
+		/* change-only capture: store only if masked inputs changed */
+		if ((!(llHdl->matMode & M58_MATCH_STORE) || llHdl->matHit) &&
+			(llHdl->captMode != M58_CAPT_CHANGE || !llHdl->captValid ||
+			 ((in ^ llHdl->captLast) & llHdl->captMask))) {
+			if (StoreRecord(llHdl, (u_int8*)&rec)) {
+				llHdl->captLast  = in;
+				llHdl->captValid = TRUE;
+			}
+		}
+
+		/* wake up fill level waiter */
+		if (llHdl->waitActive && llHdl->waitFill) {
+			MBUF_GetStat(llHdl->bufHdl, NULL, M_BUF_RD_COUNT, &bufCount);
+
+			if ((u_int32)bufCount >= llHdl->waitFill) {
+				llHdl->waitActive = FALSE;
+				OSS_SemSignal(llHdl->osHdl, llHdl->waitSem);
+			}
+		}
+
+		/* capture window */
+		if (llHdl->winState == M58_WIN_ARMED ||
+			llHdl->winState == M58_WIN_FIRED)
+			WindowStore(llHdl, (u_int8*)&rec, in);
+	}
+
+	/* edge events */
+	if (llHdl->evtMask)
+		StoreEvents(llHdl, all, tick);
+
+	/* pulse counters */
+	if (llHdl->cntRise | llHdl->cntFall)
+		CountEdges(llHdl, all);
+
+	llHdl->tsSeq++;
+}
+
+/******************************* SampleAlarm ********************************
+ *
+ *  Description: Periodic sampling alarm routine.
+ *
+ *               Takes one sample (see Sample) with masked device interrupt
+ *               and counts missed periods, i.e. if more than one period
+ *               has elapsed since the previous sample.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: arg        ll handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void SampleAlarm(
+	void *arg     /* nodoc */
+)
+{
+	LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+	OSS_IRQ_STATE irqState;
+	u_int32 tick, n;
+
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	tick = OSS_TickGet(llHdl->osHdl);
+
+	/* missed periods ? (only if period is at least one tick) */
+	if (llHdl->smpValid && llHdl->smpTicks) {
+		n = (tick - llHdl->smpLast + llHdl->smpTicks/2) / llHdl->smpTicks;
+
+		if (n > 1)
+			llHdl->smpMissed += n - 1;
+	}
+
+	llHdl->smpLast  = tick;
+	llHdl->smpValid = TRUE;
+
+	Sample(llHdl, tick);
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+}
+
+/***************************** SetSamplePeriod ******************************
+ *
+ *  Description: Start/stop periodic sampling.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               msec       sample period [msec] (0 = stop)
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SetSamplePeriod(
+	LL_HANDLE *llHdl,
+	u_int32   msec      /* nodoc */
+)
+{
+	u_int32 realMsec;
+	int32 error;
+
+	/* stop running alarm */
+	if (llHdl->smpPeriod) {
+		OSS_AlarmClear(llHdl->osHdl, llHdl->alarmHdl);
+		llHdl->smpPeriod = 0;
+	}
+
+	if (msec == 0)
+		return(ERR_SUCCESS);
+
+	llHdl->smpValid = FALSE;
+
+	/* start cyclic alarm */
+	if ((error = OSS_AlarmSet(llHdl->osHdl, llHdl->alarmHdl, msec, TRUE,
+							  &realMsec)))
+		return(error);
+
+	llHdl->smpPeriod = realMsec;
+	llHdl->smpTicks  = realMsec * OSS_TickRateGet(llHdl->osHdl) / 1000;
+
+	DBGWRT_2((DBH," sample period=%d msec (%d ticks)\n",
+			  llHdl->smpPeriod, llHdl->smpTicks));
+
+	return(ERR_SUCCESS);
+}
+
+/********************************* ModAlarm *********************************
+ *
+ *  Description: Interrupt moderation alarm routine (once per poll period).
+ *
+ *               In interrupt mode, the trigger count of the passed poll
+ *               period is reset (the threshold is checked by M58_Irq).
+ *
+ *               In polled mode, one sample is taken (see Sample). After
+ *               modHold poll periods, the interrupt is re-enabled (if not
+ *               disabled via M_MK_IRQ_ENABLE meanwhile).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: arg        ll handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void ModAlarm(
+	void *arg     /* nodoc */
+)
+{
+	LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+	OSS_IRQ_STATE irqState;
+
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	llHdl->modCount = 0;
+
+	if (llHdl->modLeft) {
+		Sample(llHdl, OSS_TickGet(llHdl->osHdl));
+
+		/* re-arm irq */
+		if (--llHdl->modLeft == 0 && llHdl->irqEnable) {
+			llHdl->ctrl3 |= IEN;
+			MWRITE_D16(llHdl->ma, CTRL3_REG, llHdl->ctrl3);
+		}
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+}
+
+/****************************** SetModeration ******************************
+ *
+ *  Description: Start/stop the interrupt moderation alarm according to
+ *               modThresh and modPeriod.
+ *
+ *               If moderation is switched off in polled mode, the
+ *               interrupt is re-enabled at once.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SetModeration(
+	LL_HANDLE *llHdl     /* nodoc */
+)
+{
+	OSS_IRQ_STATE irqState;
+	u_int32 realMsec;
+	int32 error;
+
+	/* stop running alarm */
+	if (llHdl->modActive) {
+		OSS_AlarmClear(llHdl->osHdl, llHdl->modAlarmHdl);
+		llHdl->modActive = FALSE;
+	}
+
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	llHdl->modCount = 0;
+
+	/* leave polled mode */
+	if (llHdl->modLeft) {
+		llHdl->modLeft = 0;
+
+		if (llHdl->irqEnable) {
+			llHdl->ctrl3 |= IEN;
+			MWRITE_D16(llHdl->ma, CTRL3_REG, llHdl->ctrl3);
+		}
+	}
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+	if (llHdl->modThresh == 0)
+		return(ERR_SUCCESS);
+
+	/* start cyclic alarm */
+	if ((error = OSS_AlarmSet(llHdl->osHdl, llHdl->modAlarmHdl,
+							  llHdl->modPeriod, TRUE, &realMsec)))
+		return(error);
+
+	llHdl->modActive = TRUE;
+
+	return(ERR_SUCCESS);
+}
+
+/******************************** StoreRecord *******************************
+ *
+ *  Description: Store an input buffer record (called from M58_Irq).
+ *
+ *               The record is stored with PutRecord. The buffer statistics
+ *               (stored, dropped, partial, fillMax) are updated.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               recP       record to store (recSize bytes)
+ *  Output.....: return     TRUE if the record was stored completely
+ *  Globals....: -
+ ****************************************************************************/
+static int32 StoreRecord(
+	LL_HANDLE *llHdl,
+	u_int8    *recP     /* nodoc */
+)
+{
+	int32 n, bufCount;
+
+	n = PutRecord(llHdl, llHdl->bufHdl, recP, llHdl->recSize);
+
+	if (n == 0) {
+		llHdl->statDropped++;
+		return(FALSE);
+	}
+
+	if (n < llHdl->recSize) {
+		llHdl->statPartial++;
+		return(FALSE);
+	}
+
+	llHdl->statStored++;
+
+	/* update max. fill level */
+	MBUF_GetStat(llHdl->bufHdl, NULL, M_BUF_RD_COUNT, &bufCount);
+
+	if ((u_int32)bufCount > llHdl->statFillMax)
+		llHdl->statFillMax = bufCount;
+
+	return(TRUE);
+}
+
+/******************************** FlushInBuf ********************************
+ *
+ *  Description: Discard all records of the input buffer (after a change of
+ *               the record format).
+ *
+ *               Must be called with masked interrupt, so that no record of
+ *               the new format is stored before the flush is done.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void FlushInBuf(
+	LL_HANDLE *llHdl     /* nodoc */
+)
+{
+	u_int8 tmp[4 * sizeof(M58_TS_REC)];
+	int32 bufMode, count, got;
+
+	/* no records stored in direct input mode */
+	MBUF_GetBufferMode(llHdl->bufHdl, &bufMode);
+
+	if (bufMode == M_BUF_USRCTRL)
+		return;
+
+	/* read available data only (does not wait) */
+	MBUF_GetStat(llHdl->bufHdl, NULL, M_BUF_RD_COUNT, &count);
+
+	while (count > 0) {
+		if (MBUF_Read(llHdl->bufHdl, tmp, count < (int32)sizeof(tmp) ?
+					  count : (int32)sizeof(tmp), &got) || got <= 0)
+			break;
+
+		count -= got;
+	}
+
+	DBGWRT_2((DBH, " input buffer flushed\n"));
+}
+
+/********************************* PutRecord ********************************
+ *
+ *  Description: Put a record into an input buffer (called from M58_Irq).
+ *
+ *               The record is reserved with one MBUF_GetNextBuf call and
+ *               committed with one MBUF_ReadyBuf call.
+ *
+ *               If MBUF_GetNextBuf returns less than the record size, the
+ *               record wraps around the buffer end or the buffer is nearly
+ *               full. In M_BUF_RINGBUF mode the record is dropped, if the
+ *               free buffer space is less than the record size. Otherwise
+ *               the record is stored in two parts, the second one at the
+ *               buffer start.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               bufHdl     buffer handle (MBUF_RD)
+ *               recP       record to store
+ *               size       record size [bytes]
+ *  Output.....: return     nr of bytes stored (0 = dropped)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 PutRecord(
+	LL_HANDLE   *llHdl,
+	MBUF_HANDLE *bufHdl,
+	u_int8      *recP,
+	int32       size     /* nodoc */
+)
+{
+	u_int8 *bufP;
+	int32 n, got, bufMode, bufSize, bufCount;
+
+	/* get buffer ptr for whole record - overrun ? */
+	if ((bufP = (u_int8*)MBUF_GetNextBuf(bufHdl, size, &got)) == NULL)
+		return(0);
+
+	/* record split at buffer end (or buffer nearly full) ? */
+	if (got < size) {
+		/* whole record must fit - overrun ? */
+		MBUF_GetBufferMode(bufHdl, &bufMode);
+
+		if (bufMode == M_BUF_RINGBUF) {
+			MBUF_GetStat(bufHdl, NULL, M_BUF_RD_BUFSIZE, &bufSize);
+			MBUF_GetStat(bufHdl, NULL, M_BUF_RD_COUNT, &bufCount);
+
+			if (bufSize - bufCount < size) {
+				IDBGWRT_ERR((DBH, " *** M58_Irq: buffer overrun\n"));
+				return(0);
+			}
+		}
+	}
+
+	/* store (first part of) record */
+	for (n=0; n<got; n++)
+		*bufP++ = recP[n];
+
+	/* say: buffer written */
+	MBUF_ReadyBuf(bufHdl);
+
+	if (n < size) {
+		/* store second part at buffer start */
+		if ((bufP = (u_int8*)MBUF_GetNextBuf(bufHdl, size - n, &got)) != NULL) {
+			for (got+=n; n<got; n++)
+				*bufP++ = recP[n];
+
+			MBUF_ReadyBuf(bufHdl);
+		}
+
+		if (n < size) {
+			IDBGWRT_ERR((DBH, " *** M58_Irq: partial record\n"));
+		}
+	}
+
+	return(n);
+}
+
+/******************************** StoreEvents *******************************
+ *
+ *  Description: Store edge events into the event buffer (called from
+ *               M58_Irq).
+ *
+ *               The toggled bits are found by XOR of the previous and the
+ *               current input image. One M58_EVT_REC is stored per toggled
+ *               bit of evtMask, in ascending bit order. Events which can't
+ *               be stored completely are counted as lost.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               in         current input image (see ReadFrame)
+ *               tick       OSS tick at irq entry
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void StoreEvents(
+	LL_HANDLE *llHdl,
+	u_int32   in,
+	u_int32   tick      /* nodoc */
+)
+{
+	M58_EVT_REC evt;
+	u_int32 diff, bit;
+
+	/* no previous image: nothing to compare */
+	diff = llHdl->evtValid ? (in ^ llHdl->evtLast) & llHdl->evtMask : 0;
+
+	llHdl->evtLast  = in;
+	llHdl->evtValid = TRUE;
+
+	evt.tick   = tick;
+	evt.seq    = llHdl->tsSeq;
+	evt.res[0] = evt.res[1] = 0;
+
+	/* one event per toggled bit (lowest first) */
+	while (diff) {
+		bit  = Ctz32(diff);
+		diff &= diff - 1;
+
+		evt.bit  = (u_int8)bit;
+		evt.edge = (u_int8)((in >> bit) & 1 ? M58_EDGE_RISE : M58_EDGE_FALL);
+
+		if (PutRecord(llHdl, llHdl->evtBufHdl, (u_int8*)&evt,
+					  sizeof(M58_EVT_REC)) != sizeof(M58_EVT_REC))
+			llHdl->evtLost++;
+	}
+}
+
+/******************************** CountEdges ********************************
+ *
+ *  Description: Update the pulse counters (called from M58_Irq).
+ *
+ *               The selected edges of all bits are found at once by XOR
+ *               of the previous and the current input image. Only the
+ *               counters of bits with an edge are touched.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               in         current input image (see ReadFrame)
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void CountEdges(
+	LL_HANDLE *llHdl,
+	u_int32   in        /* nodoc */
+)
+{
+	u_int32 diff, edges;
+
+	/* no previous image: nothing to compare */
+	diff = llHdl->cntValid ? in ^ llHdl->cntLast : 0;
+
+	llHdl->cntLast  = in;
+	llHdl->cntValid = TRUE;
+
+	edges = (diff & in & llHdl->cntRise) | (diff & ~in & llHdl->cntFall);
+
+	/* count edges (lowest bit first) */
+	while (edges) {
+		llHdl->cnt[Ctz32(edges)]++;
+		edges &= edges - 1;
+	}
+}
+
+/*********************************** Ctz32 **********************************
+ *
+ *  Description: Count trailing zero bits of a 32-bit value.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: x          value (must not be zero)
+ *  Output.....: return     index of lowest set bit 0..31
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 Ctz32(
+	u_int32 x     /* nodoc */
+)
+{
+	u_int32 n = 0;
+
+	if (!(x & 0xffff)) { n += 16; x >>= 16; }
+	if (!(x & 0x00ff)) { n +=  8; x >>=  8; }
+	if (!(x & 0x000f)) { n +=  4; x >>=  4; }
+	if (!(x & 0x0003)) { n +=  2; x >>=  2; }
+	if (!(x & 0x0001)) { n +=  1; }
+
+	return(n);
+}
+
+/******************************* CalcDebounce *******************************
+ *
+ *  Description: Calculate the filtered bits of the input image from the
+ *               debounce settings of all channels and restart the filter.
+ *
+ *               Must be called with masked interrupt (except from Init).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void CalcDebounce(
+	LL_HANDLE *llHdl     /* nodoc */
+)
+{
+	u_int32 n;
+
+	for (llHdl->dbMask=0, n=0; n<CH_NUMBER; n++) {
+		if (llHdl->dbCount[n] > 1)
+			llHdl->dbMask |= llHdl->dbChMask[n] << (n*8);
+	}
+
+	llHdl->dbValid = 0;
+	llHdl->dbPend  = 0;
+
+	DBGWRT_2((DBH," dbMask=0x%08x\n",llHdl->dbMask));
+}
+
+/********************************* Debounce *********************************
+ *
+ *  Description: Debounce filter, process one sample of the given input
+ *               image bits.
+ *
+ *               A filtered bit takes a new state only if the new level
+ *               was sampled dbCount times in a row. The first sample of a
+ *               bit after a restart is taken as stable state.
+ *
+ *               Must be called with masked interrupt (or from M58_Irq).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               in         raw input image
+ *               bits       sampled bits of input image
+ *  Output.....: return     filtered input image
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 Debounce(
+	LL_HANDLE *llHdl,
+	u_int32   in,
+	u_int32   bits      /* nodoc */
+)
+{
+	u_int32 mask = llHdl->dbMask & bits;
+	u_int32 init, diff, bit;
+
+	/* first sample of a bit: take as stable state */
+	init = mask & ~llHdl->dbValid;
+	llHdl->dbState  = (llHdl->dbState & ~init) | (in & init);
+	llHdl->dbValid |= init;
+
+	/* bits back at stable state: stop counting */
+	diff = (in ^ llHdl->dbState) & mask;
+	llHdl->dbPend &= ~(mask & ~diff);
+
+	/* count bits differing from stable state (lowest first) */
+	while (diff) {
+		bit  = Ctz32(diff);
+		diff &= diff - 1;
+
+		if (!(llHdl->dbPend & ((u_int32)1 << bit))) {
+			llHdl->dbPend |= (u_int32)1 << bit;
+			llHdl->dbCnt[bit] = 0;
+		}
+
+		if (++llHdl->dbCnt[bit] >= llHdl->dbCount[bit >> 3]) {
+			llHdl->dbState ^= (u_int32)1 << bit;
+			llHdl->dbPend  &= ~((u_int32)1 << bit);
+		}
+	}
+
+	return((in & ~mask) | (llHdl->dbState & mask));
+}
+
+/********************************** SigDue **********************************
+ *
+ *  Description: Check if the trigger signal is due (called from M58_Irq).
+ *
+ *               All enabled coalescing conditions (sigEvery, sigMinTicks,
+ *               sigFill) must be met. The fill threshold is re-armed when
+ *               the input buffer fill level drops below the threshold.
+ *               The fill level is checked first, so that a drop is seen
+ *               even while sigEvery or sigMinTicks hold the signal back.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               tick       OSS tick at irq entry
+ *  Output.....: return     TRUE if signal must be sent
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SigDue(
+	LL_HANDLE *llHdl,
+	u_int32   tick      /* nodoc */
+)
+{
+	int32 bufCount;
+
+	/* fill threshold crossed ? (evaluated first, to see every drop) */
+	if (llHdl->sigFill) {
+		MBUF_GetStat(llHdl->bufHdl, NULL, M_BUF_RD_COUNT, &bufCount);
+
+		if ((u_int32)bufCount < llHdl->sigFill) {
+			llHdl->sigArmed = TRUE;
+			return(FALSE);
+		}
+
+		if (!llHdl->sigArmed)
+			return(FALSE);
+	}
+
+	/* n triggers since last signal ? */
+	if (llHdl->sigPend < llHdl->sigEvery)
+		return(FALSE);
+
+	/* min. interval since last signal ? */
+	if (tick - llHdl->sigLast < llHdl->sigMinTicks)
+		return(FALSE);
+
+	/* fill threshold used up until next drop */
+	llHdl->sigArmed = FALSE;
+
+	return(TRUE);
+}
+
+/********************************* WaitTrig *********************************
+ *
+ *  Description: Wait for triggers or input buffer fill level (see
+ *               M58_BLK_WAIT_TRIG getstat).
+ *
+ *               The device semaphore is released while waiting. M58_Irq
+ *               (trigger count) or Sample (fill level) signals waitSem
+ *               when the condition is reached.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               waitP      wait parameters (count, fill, tout)
+ *  Output.....: return     success (0) or error code
+ *               waitP      results (trigCount, elapsed)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 WaitTrig(
+	LL_HANDLE *llHdl,
+	M58_WAIT  *waitP     /* nodoc */
+)
+{
+	OSS_IRQ_STATE irqState;
+	u_int32 start, ticks, rate;
+	int32 bufCount, error = ERR_SUCCESS;
+
+	start = OSS_TickGet(llHdl->osHdl);
+
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	/* wait of another caller running ? */
+	if (llHdl->waitActive) {
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+		return(ERR_LL_DEV_BUSY);
+	}
+
+	llHdl->waitLeft = waitP->count;
+	llHdl->waitFill = waitP->fill;
+
+	if (llHdl->waitLeft == 0 && llHdl->waitFill == 0)
+		llHdl->waitLeft = 1;
+
+	/* fill level already reached ? */
+	MBUF_GetStat(llHdl->bufHdl, NULL, M_BUF_RD_COUNT, &bufCount);
+
+	if (llHdl->waitFill == 0 || (u_int32)bufCount < llHdl->waitFill) {
+		/* 'no count' means: until fill level reached */
+		if (llHdl->waitLeft == 0)
+			llHdl->waitLeft = 0xffffffff;
+
+		llHdl->waitActive = TRUE;
+	}
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+	if (llHdl->waitActive) {
+		/* wait (release device semaphore meanwhile) */
+		OSS_SemSignal(llHdl->osHdl, llHdl->devSemHdl);
+		error = OSS_SemWait(llHdl->osHdl, llHdl->waitSem,
+							waitP->tout ? (int32)waitP->tout :
+							OSS_SEM_WAITFOREVER);
+		OSS_SemWait(llHdl->osHdl, llHdl->devSemHdl, OSS_SEM_WAITFOREVER);
+
+		/* stop waiting */
+		irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+		if (error && !llHdl->waitActive) {
+			/* reached just after timeout: take late signal */
+			OSS_SemWait(llHdl->osHdl, llHdl->waitSem, 0);
+			error = ERR_SUCCESS;
+		}
+		llHdl->waitActive = FALSE;
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+	}
+
+	/* return trigger count and elapsed time */
+	ticks = OSS_TickGet(llHdl->osHdl) - start;
+	rate  = OSS_TickRateGet(llHdl->osHdl);
+
+	waitP->trigCount = llHdl->statTrig;
+	waitP->elapsed   = (ticks / rate) * 1000 + ((ticks % rate) * 1000) / rate;
+
+	if (error) {
+		DBGWRT_ERR((DBH, " *** M58_GetStat: wait trigger timeout\n"));
+	}
+
+	return(error);
+}
+
+/******************************* WindowStore ********************************
+ *
+ *  Description: Record one sample into the capture window history (called
+ *               from Sample, while the window is armed or fired).
+ *
+ *               The history is a circular buffer of winPre+winPost records,
+ *               where the oldest record is overwritten. When armed, only
+ *               the last winPre records are kept. When the arm condition
+ *               fires, the firing record and winPost-1 further records are
+ *               added, then the capture is frozen (M58_WIN_DONE).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               recP       record (recSize bytes)
+ *               in         input image
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void WindowStore(
+	LL_HANDLE *llHdl,
+	u_int8    *recP,
+	u_int32   in       /* nodoc */
+)
+{
+	u_int8 *dstP = llHdl->winBuf + llHdl->winIdx * llHdl->recSize;
+	u_int32 match, fire;
+	int32 n;
+
+	/* copy record into history */
+	for (n=0; n<llHdl->recSize; n++)
+		*dstP++ = *recP++;
+
+	if (++llHdl->winIdx == llHdl->winPre + llHdl->winPost)
+		llHdl->winIdx = 0;
+
+	/* recording post-trigger records */
+	if (llHdl->winState == M58_WIN_FIRED) {
+		llHdl->winCount++;
+
+		if (--llHdl->winLeft == 0)
+			llHdl->winState = M58_WIN_DONE;
+		return;
+	}
+
+	/* armed: check condition (becomes true / pre-trigger complete) */
+	if (llHdl->winMask) {
+		match = ((in & llHdl->winMask) == llHdl->winValue);
+		fire  = match && !llHdl->winMatch;
+		llHdl->winMatch = match;
+	}
+	else
+		fire = (llHdl->winCount == llHdl->winPre);
+
+	if (fire) {
+		llHdl->winCount++;
+		llHdl->winLeft  = llHdl->winPost - 1;
+		llHdl->winState = llHdl->winLeft ? M58_WIN_FIRED : M58_WIN_DONE;
+	}
+	else if (llHdl->winCount < llHdl->winPre)
+		llHdl->winCount++;
+}
+
+/******************************* MatchTable *********************************
+ *
+ *  Description: Check the input image against the pattern match table.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               in         input image
+ *  Output.....: return     TRUE if any entry matches
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 MatchTable(
+	LL_HANDLE *llHdl,
+	u_int32   in       /* nodoc */
+)
+{
+	u_int32 n;
+
+	for (n=0; n<llHdl->matCount; n++)
+		if ((in & llHdl->matMask[n]) == llHdl->matValue[n])
+			return(TRUE);
+
+	return(FALSE);
+}
+
+/******************************** WritePort *********************************
+ *
+ *  Description: Write one output channel and update the output shadow.
+ *
+ *               Must be called with interrupts masked, if not called from
+ *               M58_Irq (the shadow is shared with the reflex rules).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               ch         channel
+ *               value      value to write
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void WritePort(
+	LL_HANDLE *llHdl,
+	int32     ch,
+	u_int8    value     /* nodoc */
+)
+{
+	u_int32 shift = ch * 8;
+
+	MWRITE_D8(llHdl->ma, llHdl->portReg[ch], value);
+	llHdl->statBusD8++;
+
+	llHdl->outImage = (llHdl->outImage & ~((u_int32)0xff << shift)) |
+					  ((u_int32)value << shift);
+}
+
+/********************************* OutBits **********************************
+ *
+ *  Description: Get the bits of all channels configured as output (bit
+ *               layout as for the output shadow).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *  Output.....: return     output bits
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 OutBits(
+	LL_HANDLE *llHdl     /* nodoc */
+)
+{
+	u_int32 ch, bits = 0;
+
+	for (ch=0; ch<CH_NUMBER; ch++)
+		if (llHdl->portDir[ch] == PORT_DIR_OUT)
+			bits |= (u_int32)0xff << (ch * 8);
+
+	return(bits);
+}
+
+/********************************* ChanBits *********************************
+ *
+ *  Description: Expand input image bits to the bits of their channels
+ *               (0xff for each channel with at least one bit set).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: bits       input image bits
+ *  Output.....: return     channel bits
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 ChanBits(
+	u_int32 bits     /* nodoc */
+)
+{
+	/* fold each byte into its bit 0 */
+	bits |= bits >> 4;
+	bits |= bits >> 2;
+	bits |= bits >> 1;
+
+	return((bits & 0x01010101) * 0xff);
+}
+
+/********************************* ReadPorts ********************************
+ *
+ *  Description: Read the given channels into one image. Input channels are
+ *               read from the hardware, output channels are taken from the
+ *               output shadow.
+ *
+ *               Both ports of a pair (A/B or C/D) configured as input are
+ *               read with one D16 cycle. If the debounce filter is enabled,
+ *               the filtered input values are returned.
+ *
+ *               Must be called with masked interrupt (or from M58_Irq).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               bits       channel bits to read (0xff per channel)
+ *  Output.....: return     image of channels (port A..D = bit 0..31)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 ReadPorts(
+	LL_HANDLE *llHdl,
+	u_int32   bits      /* nodoc */
+)
+{
+	static const u_int8 pairReg[CH_NUMBER/2] = { PORTAB_REG, PORTCD_REG };
+	u_int32 n, in = 0, outBits = OutBits(llHdl) & bits;
+	u_int32 inBits = ~outBits & bits;
+
+	for (n=0; n<CH_NUMBER; n+=2) {
+		switch ((inBits >> (n * 8)) & 0xffff) {
+			case 0xffff:
+				in |= (u_int32)MREAD_D16(llHdl->ma, pairReg[n/2]) << (n * 8);
+				llHdl->statBusD16++;
+				break;
+			case 0x00ff:
+				in |= (u_int32)MREAD_D8(llHdl->ma, llHdl->portReg[n]) << (n * 8);
+				llHdl->statBusD8++;
+				break;
+			case 0xff00:
+				in |= (u_int32)MREAD_D8(llHdl->ma, llHdl->portReg[n+1]) <<
+					  (n * 8 + 8);
+				llHdl->statBusD8++;
+				break;
+		}
+	}
+
+	/* debounce filter */
+	if (llHdl->dbMask & inBits)
+		in = Debounce(llHdl, in, inBits);
+
+	return((in & inBits) | (llHdl->outImage & outBits));
+}
+
+/******************************** ReadInputs ********************************
+ *
+ *  Description: Read all input channels into one image and merge the output
+ *               shadow (see M58_PORTS_ALL getstat and ReadPorts).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *  Output.....: return     image of all channels (port A..D = bit 0..31)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 ReadInputs(
+	LL_HANDLE *llHdl     /* nodoc */
+)
+{
+	OSS_IRQ_STATE irqState;
+	u_int32 in;
+
+	/* debounce filter and bus counters are shared with M58_Irq */
+	irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	in = ReadPorts(llHdl, 0xffffffff);
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+	return(in);
+}
+
+/******************************* WriteOutputs *******************************
+ *
+ *  Description: Write a new output image. Only the output channels, whose
+ *               value differs from the output shadow, are written.
+ *
+ *               Bits of channels not configured as output are ignored.
+ *               Must be called with interrupts masked (see WritePort).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               image      output image (port A..D = bit 0..31)
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void WriteOutputs(
+	LL_HANDLE *llHdl,
+	u_int32   image     /* nodoc */
+)
+{
+	u_int32 diff = (image ^ llHdl->outImage) & OutBits(llHdl);
+	int32 ch;
+
+	for (ch=0; diff; ch++, diff >>= 8, image >>= 8)
+		if (diff & 0xff)
+			WritePort(llHdl, ch, (u_int8)image);
+}
+
+/********************************** Reflex **********************************
+ *
+ *  Description: Evaluate the reflex rules for one sample (called from
+ *               Sample) and apply the actions of matching rules to the
+ *               output channels.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               in         input image
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Reflex(
+	LL_HANDLE *llHdl,
+	u_int32   in       /* nodoc */
+)
+{
+	u_int32 n, bit, last = llHdl->rflLast;
+	int32 ch;
+	u_int8 value;
+
+	for (n=0; n<llHdl->rflCount; n++) {
+		bit = (u_int32)1 << n;
+
+		/* condition not met ? */
+		if ((in & llHdl->rflMask[n]) != llHdl->rflValue[n]) {
+			llHdl->rflLast &= ~bit;
+			continue;
+		}
+
+		llHdl->rflLast |= bit;
+
+		/* edge rule: already fired ? */
+		if ((llHdl->rflAction[n] & M58_RFL_EDGE) && (last & bit))
+			continue;
+
+		/* skip channel not configured as output */
+		ch = llHdl->rflPort[n];
+
+		if (llHdl->portDir[ch] != PORT_DIR_OUT)
+			continue;
+
+		value = (u_int8)(llHdl->outImage >> (ch * 8));
+
+		switch (llHdl->rflAction[n] & ~M58_RFL_EDGE) {
+			case M58_RFL_SET:	value |= llHdl->rflData[n];		break;
+			case M58_RFL_CLR:	value &= ~llHdl->rflData[n];	break;
+			case M58_RFL_XOR:	value ^= llHdl->rflData[n];		break;
+			case M58_RFL_WRITE:	value  = llHdl->rflData[n];		break;
+		}
+
+		WritePort(llHdl, ch, value);
+		llHdl->rflHits[n]++;
+	}
+}
+
+/******************************** ReadIdProm ********************************
+ *
+ *  Description: Read the whole id prom into the id prom cache.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void ReadIdProm(
+	LL_HANDLE *llHdl     /* nodoc */
+)
+{
+	u_int8 n;
+
+	for (n=0; n<MOD_ID_SIZE/2; n++)		/* read MOD_ID_SIZE/2 words */
+		llHdl->idData[n] = (u_int16)m_read((U_INT32_OR_64)llHdl->ma, n);
+
+	llHdl->idValid = TRUE;
+}
+
+/********************************* CmdList **********************************
+ *
+ *  Description: Execute a command list (see M58_BLK_CMDLIST getstat).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               cmdP       command list
+ *               count      nr of commands
+ *  Output.....: return     success (0) or error code
+ *               cmdP       results
+ *               *doneP     nr of commands executed successfully
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CmdList(
+	LL_HANDLE *llHdl,
+	M58_CMD   *cmdP,
+	u_int32   count,
+	u_int32   *doneP     /* nodoc */
+)
+{
+	OSS_IRQ_STATE irqState;
+	M58_WAIT wait;
+	int32 value, error = ERR_SUCCESS;
+	u_int32 n, image;
+
+	/* device is released while waiting: allow WAIT_TRIG only at the end */
+	for (n=0; n+1<count; n++) {
+		if (cmdP[n].op == M58_CMD_WAIT_TRIG) {
+			DBGWRT_ERR((DBH, " *** M58_GetStat: WAIT_TRIG not last "
+						"command\n"));
+			*doneP = 0;
+			return(ERR_LL_ILL_PARAM);
+		}
+	}
+
+	for (n=0; n<count; n++, cmdP++) {
+		/* check channel */
+		if (cmdP->op <= M58_CMD_CLRBITS && cmdP->ch >= CH_NUMBER) {
+			error = ERR_LL_ILL_CHAN;
+			break;
+		}
+
+		switch (cmdP->op) {
+			case M58_CMD_READ:
+				error = M58_Read(llHdl, cmdP->ch, &value);
+				break;
+			case M58_CMD_WRITE:
+				value = cmdP->arg & 0xff;
+				error = M58_Write(llHdl, cmdP->ch, value);
+				break;
+			case M58_CMD_SETBITS:
+			case M58_CMD_CLRBITS:
+				if (llHdl->portDir[cmdP->ch] != PORT_DIR_OUT) {
+					error = ERR_LL_ILL_DIR;
+					break;
+				}
+
+				/* read-modify-write (output shadow is shared with Reflex) */
+				irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+				image = (cmdP->arg & 0xff) << (cmdP->ch * 8);
+
+				if (cmdP->op == M58_CMD_SETBITS)
+					image = llHdl->outImage | image;
+				else
+					image = llHdl->outImage & ~image;
+
+				WriteOutputs(llHdl, image);
+				value = (llHdl->outImage >> (cmdP->ch * 8)) & 0xff;
+				OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+				break;
+			case M58_CMD_DELAY_US:
+				/* device is locked: limit busy-wait */
+				if (cmdP->arg > M58_CMD_DELAY_MAX) {
+					error = ERR_LL_ILL_PARAM;
+					break;
+				}
+
+				if (!llHdl->cmdDelay) {
+					if ((error = OSS_MikroDelayInit(llHdl->osHdl)))
+						break;
+					llHdl->cmdDelay = TRUE;
+				}
+
+				OSS_MikroDelay(llHdl->osHdl, cmdP->arg);
+				value = 0;
+				break;
+			case M58_CMD_WAIT_TRIG:
+				wait.count = 1;
+				wait.fill  = 0;
+				wait.tout  = cmdP->arg;
+				error = WaitTrig(llHdl, &wait);
+				value = wait.trigCount;
+				break;
+			default:
+				error = ERR_LL_ILL_PARAM;
+		}
+
+		if (error)
+			break;
+
+		cmdP->result = value;
+	}
+
+	*doneP = n;
+
+	if (error) {
+		DBGWRT_ERR((DBH, " *** M58_GetStat: command %d failed\n", n));
+	}
+
+	return(error);
+}
+
+/******************************* WindowRead *********************************
+ *
+ *  Description: Copy the frozen capture window in chronological order into
+ *               the user buffer and disarm the window (see M58_BlockRead).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl        ll handle
+ *               bufP         data buffer
+ *               size         data buffer size
+ *  Output.....: nbrRdBytesP  number of read bytes (0 = not complete)
+ *               return       success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 WindowRead(
+	LL_HANDLE *llHdl,
+	u_int8    *bufP,
+	int32     size,
+	int32     *nbrRdBytesP     /* nodoc */
+)
+{
+	u_int32 depth = llHdl->winPre + llHdl->winPost;
+	u_int32 idx, n;
+	u_int8 *srcP;
+	int32 i;
+
+	*nbrRdBytesP = 0;
+
+	/* capture not complete ? (M58_Irq doesn't touch a frozen capture) */
+	if (llHdl->winState != M58_WIN_DONE)
+		return(ERR_SUCCESS);
+
+	if (size < (int32)(depth * llHdl->recSize))
+		return(ERR_LL_USERBUF);
+
+	/* oldest record of capture */
+	idx = (llHdl->winIdx + depth - llHdl->winCount) % depth;
+
+	for (n=0; n<llHdl->winCount; n++) {
+		srcP = llHdl->winBuf + idx * llHdl->recSize;
+
+		for (i=0; i<llHdl->recSize; i++)
+			*bufP++ = *srcP++;
+
+		if (++idx == depth)
+			idx = 0;
+	}
+
+	*nbrRdBytesP = llHdl->winCount * llHdl->recSize;
+	llHdl->winState = M58_WIN_IDLE;
+
+	return(ERR_SUCCESS);
+}
+
+/****************************** WriteSplitFrame *****************************
+ *
+ *  Description: Write an output frame which is not completely returned by
+ *               MBUF_GetNextBuf (called from M58_Irq).
+ *
+ *               This happens, if the frame wraps around the buffer end or
+ *               if the buffer holds less than one frame. In the latter
+ *               case nothing is written. Otherwise the frame is taken in
+ *               two parts, the second one from the buffer start.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      ll handle
+ *               bufP       buffer ptr returned by MBUF_GetNextBuf
+ *               got        nr of bytes available at bufP
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void WriteSplitFrame(
+	LL_HANDLE *llHdl,
+	u_int8    *bufP,
+	int32     got       /* nodoc */
+)
+{
+	u_int8 frame[CH_NUMBER];
+	int32 n, bufCount;
+
+	/* whole frame must be available - underrun ? */
+	MBUF_GetStat(NULL, llHdl->wrBufHdl, M_BUF_WR_COUNT, &bufCount);
+
+	if (bufCount < llHdl->bufWrSize)
+		return;
 
+	/* take first part up to buffer end */
+	for (n=0; n<got; n++)
+		frame[n] = *bufP++;
 
+	MBUF_ReadyBuf(llHdl->wrBufHdl);
 
+	/* take second part from buffer start */
+	if ((bufP = (u_int8*)MBUF_GetNextBuf(llHdl->wrBufHdl,
+										 llHdl->bufWrSize - got, &got)) == NULL)
+		return;
+
+	for (got+=n; n<got; n++)
+		frame[n] = *bufP++;
+
+	MBUF_ReadyBuf(llHdl->wrBufHdl);
+
+	WriteFrame(llHdl, frame);
+}
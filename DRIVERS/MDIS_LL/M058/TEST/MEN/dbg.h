@@ -0,0 +1,31 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: dbg.h
+ *
+ *  Description: Host stand-in for the debug macros (M58 simulator)
+ *
+ *               Debug output is compiled out.
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _DBG_H
+#define _DBG_H
+
+typedef void DBG_HANDLE;
+
+#define DBGINIT(x)
+#define DBGEXIT(x)
+#define DBGWRT_1(x)
+#define DBGWRT_2(x)
+#define DBGWRT_3(x)
+#define DBGWRT_ERR(x)
+#define IDBGWRT_1(x)
+#define IDBGWRT_2(x)
+#define IDBGWRT_3(x)
+#define IDBGWRT_ERR(x)
+
+#endif /* _DBG_H */
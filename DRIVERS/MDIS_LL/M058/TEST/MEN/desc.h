@@ -0,0 +1,32 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: desc.h
+ *
+ *  Description: Host stand-in for the descriptor functions (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _DESC_H
+#define _DESC_H
+
+#include <MEN/oss.h>
+
+typedef void				DESC_SPEC;
+typedef struct DESC_HANDLE	DESC_HANDLE;
+
+extern char *DESC_Ident(void);
+extern int32 DESC_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+					   DESC_HANDLE **descHandleP);
+extern int32 DESC_Exit(DESC_HANDLE **descHandleP);
+extern int32 DESC_DbgLevelSet(DESC_HANDLE *descHandle, u_int32 dbgLevel);
+extern int32 DESC_GetUInt32(DESC_HANDLE *descHandle, u_int32 defVal,
+							u_int32 *valueP, char *keyFmt, ...);
+extern int32 DESC_GetBinary(DESC_HANDLE *descHandle, u_int8 *defVal,
+							u_int32 defLen, u_int8 *bufP, u_int32 *lenP,
+							char *keyFmt, ...);
+
+#endif /* _DESC_H */
@@ -0,0 +1,38 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: ll_defs.h
+ *
+ *  Description: Host stand-in for the low level driver definitions
+ *               (M58 simulator)
+ *
+ *     Switches: _NO_LL_HANDLE
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _LL_DEFS_H
+#define _LL_DEFS_H
+
+#ifndef _NO_LL_HANDLE
+typedef void LL_HANDLE;
+#endif
+
+/* M_xxx_Irq return values */
+#define LL_IRQ_DEVICE		0
+#define LL_IRQ_DEV_NOT		1
+#define LL_IRQ_UNKNOWN		2
+
+/* M_xxx_Info codes */
+#define LL_INFO_HW_CHARACTER	1
+#define LL_INFO_ADDRSPACE_COUNT	2
+#define LL_INFO_ADDRSPACE		3
+#define LL_INFO_IRQ				4
+#define LL_INFO_LOCKMODE		5
+
+/* lock modes */
+#define LL_LOCK_NONE		0
+#define LL_LOCK_CALL		1
+#define LL_LOCK_CHAN		2
+
+#endif /* _LL_DEFS_H */
@@ -0,0 +1,40 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: ll_entry.h
+ *
+ *  Description: Host stand-in for the low level driver jump table
+ *               (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _LL_ENTRY_H
+#define _LL_ENTRY_H
+
+#include <MEN/maccess.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+
+typedef struct {
+	int32 (*init)(DESC_SPEC *descSpec, OSS_HANDLE *osHdl, MACCESS *ma,
+				  OSS_SEM_HANDLE *devSemHdl, OSS_IRQ_HANDLE *irqHdl,
+				  LL_HANDLE **llHdlP);
+	int32 (*exit)(LL_HANDLE **llHdlP);
+	int32 (*read)(LL_HANDLE *llHdl, int32 ch, int32 *valueP);
+	int32 (*write)(LL_HANDLE *llHdl, int32 ch, int32 value);
+	int32 (*blockRead)(LL_HANDLE *llHdl, int32 ch, void *buf, int32 size,
+					   int32 *nbrRdBytesP);
+	int32 (*blockWrite)(LL_HANDLE *llHdl, int32 ch, void *buf, int32 size,
+						int32 *nbrWrBytesP);
+	int32 (*setStat)(LL_HANDLE *llHdl, int32 code, int32 ch,
+					 INT32_OR_64 value32_or_64);
+	int32 (*getStat)(LL_HANDLE *llHdl, int32 code, int32 ch,
+					 INT32_OR_64 *value32_or_64P);
+	int32 (*irq)(LL_HANDLE *llHdl);
+	int32 (*info)(int32 infoType, ...);
+} LL_ENTRY;
+
+#endif /* _LL_ENTRY_H */
@@ -0,0 +1,37 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: maccess.h
+ *
+ *  Description: Host stand-in for the MACCESS macros (M58 simulator)
+ *
+ *               All accesses are routed to the M58 register model
+ *               (see sim_hw.c).
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MACCESS_H
+#define _MACCESS_H
+
+#include <MEN/men_typs.h>
+
+typedef u_int8 *MACCESS;
+
+extern u_int8  SIM_ReadD8(MACCESS ma, u_int32 offs);
+extern u_int16 SIM_ReadD16(MACCESS ma, u_int32 offs);
+extern void    SIM_WriteD8(MACCESS ma, u_int32 offs, u_int8 val);
+extern void    SIM_WriteD16(MACCESS ma, u_int32 offs, u_int16 val);
+
+#define MREAD_D8(ma,offs)			SIM_ReadD8(ma,offs)
+#define MREAD_D16(ma,offs)			SIM_ReadD16(ma,offs)
+#define MWRITE_D8(ma,offs,val)		SIM_WriteD8(ma,offs,(u_int8)(val))
+#define MWRITE_D16(ma,offs,val)		SIM_WriteD16(ma,offs,(u_int16)(val))
+#define MSETMASK_D16(ma,offs,mask)	\
+	SIM_WriteD16(ma,offs,(u_int16)(SIM_ReadD16(ma,offs) | (mask)))
+#define MCLRMASK_D16(ma,offs,mask)	\
+	SIM_WriteD16(ma,offs,(u_int16)(SIM_ReadD16(ma,offs) & ~(mask)))
+
+#endif /* _MACCESS_H */
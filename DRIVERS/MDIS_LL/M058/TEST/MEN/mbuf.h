@@ -0,0 +1,45 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mbuf.h
+ *
+ *  Description: Host stand-in for the buffer functions (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MBUF_H
+#define _MBUF_H
+
+#include <MEN/oss.h>
+
+typedef struct MBUF_HANDLE MBUF_HANDLE;
+
+/* buffer direction */
+#define MBUF_RD		0
+#define MBUF_WR		1
+
+extern char *MBUF_Ident(void);
+extern int32 MBUF_Create(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *devSem,
+						 void *lldrvHdl, int32 size, int32 width,
+						 int32 mode, int32 direction, int32 highWater,
+						 int32 timeout, OSS_IRQ_HANDLE *irqHdl,
+						 MBUF_HANDLE **bufHdlP);
+extern int32 MBUF_Remove(MBUF_HANDLE **bufHdlP);
+extern int32 MBUF_Read(MBUF_HANDLE *bufHdl, u_int8 *buffer, int32 length,
+					   int32 *nbrRdBytesP);
+extern int32 MBUF_Write(MBUF_HANDLE *bufHdl, u_int8 *buffer, int32 length,
+						int32 *nbrWrBytesP);
+extern void *MBUF_GetNextBuf(MBUF_HANDLE *bufHdl, int32 nbrOfBlocks,
+							 int32 *gotBlocksP);
+extern int32 MBUF_ReadyBuf(MBUF_HANDLE *bufHdl);
+extern int32 MBUF_EventHdlr(MBUF_HANDLE *bufHdl, int32 event);
+extern int32 MBUF_SetStat(MBUF_HANDLE *inBufHdl, MBUF_HANDLE *outBufHdl,
+						  int32 code, int32 value);
+extern int32 MBUF_GetStat(MBUF_HANDLE *inBufHdl, MBUF_HANDLE *outBufHdl,
+						  int32 code, int32 *valueP);
+extern int32 MBUF_GetBufferMode(MBUF_HANDLE *bufHdl, int32 *valueP);
+
+#endif /* _MBUF_H */
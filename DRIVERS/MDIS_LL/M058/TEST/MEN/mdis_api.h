@@ -0,0 +1,77 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mdis_api.h
+ *
+ *  Description: Host stand-in for the MDIS global definitions
+ *               (M58 simulator)
+ *
+ *               Only the codes used by the M58 driver are defined. The
+ *               values need not match MDIS, since driver and simulator
+ *               are always built together.
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MDIS_API_H
+#define _MDIS_API_H
+
+#include <MEN/men_typs.h>
+
+/* status code ranges */
+#define M_MK_OF				0x0000
+#define M_LL_OF				0x0100
+#define M_DEV_OF			0x0200
+#define M_BUF_OF			0x0f00
+#define M_MK_BLK_OF			0x8000
+#define M_LL_BLK_OF			0x8100
+#define M_DEV_BLK_OF		0x8200
+
+#define M_BUF_CODE(code)	((code) >= M_BUF_OF && (code) < M_BUF_OF+0x100)
+
+/* mdis kernel codes */
+#define M_MK_IRQ_ENABLE		(M_MK_OF+0x01)
+#define M_MK_IRQ_COUNT		(M_MK_OF+0x02)
+#define M_MK_BLK_REV_ID		(M_MK_BLK_OF+0x01)
+
+/* low level driver codes */
+#define M_LL_DEBUG_LEVEL	(M_LL_OF+0x00)
+#define M_LL_CH_NUMBER		(M_LL_OF+0x01)
+#define M_LL_CH_DIR			(M_LL_OF+0x02)
+#define M_LL_CH_LEN			(M_LL_OF+0x03)
+#define M_LL_CH_TYP			(M_LL_OF+0x04)
+#define M_LL_IRQ_COUNT		(M_LL_OF+0x05)
+#define M_LL_ID_CHECK		(M_LL_OF+0x06)
+#define M_LL_ID_SIZE		(M_LL_OF+0x07)
+#define M_LL_BLK_ID_DATA	(M_LL_BLK_OF+0x00)
+
+/* buffer codes */
+#define M_BUF_RD_MODE			(M_BUF_OF+0x00)
+#define M_BUF_RD_BUFSIZE		(M_BUF_OF+0x01)
+#define M_BUF_RD_COUNT			(M_BUF_OF+0x02)
+#define M_BUF_RD_DEBUG_LEVEL	(M_BUF_OF+0x03)
+#define M_BUF_WR_MODE			(M_BUF_OF+0x40)
+#define M_BUF_WR_COUNT			(M_BUF_OF+0x42)
+#define M_BUF_WR_DEBUG_LEVEL	(M_BUF_OF+0x43)
+
+/* buffer modes */
+#define M_BUF_USRCTRL			0
+#define M_BUF_CURRBUF			1
+#define M_BUF_RINGBUF			2
+#define M_BUF_RINGBUF_OVERWR	3
+
+/* channel direction/type */
+#define M_CH_IN			0
+#define M_CH_OUT		1
+#define M_CH_INOUT		2
+#define M_CH_BINARY		0
+
+/* block getstat/setstat data */
+typedef struct {
+	int32	size;		/* data size [bytes] */
+	void	*data;		/* data pointer */
+} M_SG_BLOCK;
+
+#endif /* _MDIS_API_H */
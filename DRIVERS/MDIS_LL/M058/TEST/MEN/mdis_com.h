@@ -0,0 +1,31 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mdis_com.h
+ *
+ *  Description: Host stand-in for the MDIS common definitions
+ *               (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MDIS_COM_H
+#define _MDIS_COM_H
+
+/* address/data modes */
+#define MDIS_MA08		0x01
+#define MDIS_MD08		0x01
+#define MDIS_MD16		0x02
+
+/* ident function table */
+#define MDIS_MAX_IDENT_FUNCT	8
+
+typedef struct {
+	struct {
+		char *(*identCall)(void);
+	} idCall[MDIS_MAX_IDENT_FUNCT];
+} MDIS_IDENT_FUNCT_TBL;
+
+#endif /* _MDIS_COM_H */
@@ -0,0 +1,48 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mdis_err.h
+ *
+ *  Description: Host stand-in for the MDIS error codes (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MDIS_ERR_H
+#define _MDIS_ERR_H
+
+#define ERR_SUCCESS				0
+
+/* oss errors */
+#define ERR_OSS					0x0100
+#define ERR_OSS_MEM_ALLOC		(ERR_OSS+0x01)
+#define ERR_OSS_SIG_SET			(ERR_OSS+0x02)
+#define ERR_OSS_SIG_CLR			(ERR_OSS+0x03)
+#define ERR_OSS_TIMEOUT			(ERR_OSS+0x04)
+#define ERR_OSS_BUSY_RESOURCE	(ERR_OSS+0x05)
+
+/* descriptor errors */
+#define ERR_DESC				0x0200
+#define ERR_DESC_KEY_NOTFOUND	(ERR_DESC+0x01)
+
+/* low level driver errors */
+#define ERR_LL					0x0300
+#define ERR_LL_ILL_PARAM		(ERR_LL+0x01)
+#define ERR_LL_ILL_ID			(ERR_LL+0x02)
+#define ERR_LL_ILL_DIR			(ERR_LL+0x03)
+#define ERR_LL_UNK_CODE			(ERR_LL+0x04)
+#define ERR_LL_USERBUF			(ERR_LL+0x05)
+#define ERR_LL_READ				(ERR_LL+0x06)
+#define ERR_LL_WRITE			(ERR_LL+0x07)
+#define ERR_LL_ILL_CHAN			(ERR_LL+0x08)
+#define ERR_LL_DEV_BUSY			(ERR_LL+0x09)
+#define ERR_LL_ILL_FUNC			(ERR_LL+0x0a)
+
+/* buffer errors */
+#define ERR_MBUF				0x0400
+#define ERR_MBUF_OVERFLOW		(ERR_MBUF+0x01)
+#define ERR_MBUF_NO_BUF			(ERR_MBUF+0x02)
+
+#endif /* _MDIS_ERR_H */
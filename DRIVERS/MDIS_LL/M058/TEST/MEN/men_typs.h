@@ -0,0 +1,42 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: men_typs.h
+ *
+ *  Description: Host stand-in for the MEN type definitions (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MEN_TYPS_H
+#define _MEN_TYPS_H
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+typedef int8_t		int8;
+typedef uint8_t		u_int8;
+typedef int16_t		int16;
+typedef uint16_t	u_int16;
+typedef int32_t		int32;
+typedef uint32_t	u_int32;
+
+#define INT32_OR_64		intptr_t
+#define U_INT32_OR_64	uintptr_t
+
+#ifndef TRUE
+# define TRUE	1
+#endif
+#ifndef FALSE
+# define FALSE	0
+#endif
+
+#define IN_RANGE(x,lo,hi)	((x) >= (lo) && (x) <= (hi))
+
+#define MENT_STR(x)		#x
+#define MENT_XSTR(x)	MENT_STR(x)
+
+#endif /* _MEN_TYPS_H */
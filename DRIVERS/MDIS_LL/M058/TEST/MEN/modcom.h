@@ -0,0 +1,20 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: modcom.h
+ *
+ *  Description: Host stand-in for the id prom functions (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MODCOM_H
+#define _MODCOM_H
+
+#include <MEN/men_typs.h>
+
+extern int m_read(U_INT32_OR_64 ma, u_int8 index);
+
+#endif /* _MODCOM_H */
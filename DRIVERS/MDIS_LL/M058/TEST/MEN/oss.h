@@ -0,0 +1,72 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: oss.h
+ *
+ *  Description: Host stand-in for the OSS functions (M58 simulator)
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _OSS_H
+#define _OSS_H
+
+#include <MEN/men_typs.h>
+
+typedef struct OSS_HANDLE		OSS_HANDLE;
+typedef struct OSS_IRQ_HANDLE	OSS_IRQ_HANDLE;
+typedef struct OSS_SIG_HANDLE	OSS_SIG_HANDLE;
+typedef struct OSS_SEM_HANDLE	OSS_SEM_HANDLE;
+typedef struct OSS_ALARM_HANDLE	OSS_ALARM_HANDLE;
+typedef int32					OSS_IRQ_STATE;
+
+#define OSS_DBG_DEFAULT		0
+
+#define OSS_SEM_BIN			0
+#define OSS_SEM_COUNT		1
+#define OSS_SEM_NOWAIT		0
+#define OSS_SEM_WAITFOREVER	(-1)
+
+extern char *OSS_Ident(void);
+
+extern void *OSS_MemGet(OSS_HANDLE *osHdl, u_int32 size, u_int32 *gotsizeP);
+extern int32 OSS_MemFree(OSS_HANDLE *osHdl, void *addr, u_int32 size);
+extern void OSS_MemFill(OSS_HANDLE *osHdl, u_int32 size, char *adr,
+						int8 value);
+extern void OSS_MemCopy(OSS_HANDLE *osHdl, u_int32 size, char *src,
+						char *dest);
+
+extern int32 OSS_SigCreate(OSS_HANDLE *osHdl, int32 signal,
+						   OSS_SIG_HANDLE **sigHandleP);
+extern int32 OSS_SigRemove(OSS_HANDLE *osHdl, OSS_SIG_HANDLE **sigHandleP);
+extern int32 OSS_SigSend(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle);
+extern int32 OSS_SigInfo(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle,
+						 int32 *signalNbrP, int32 *processIdP);
+
+extern int32 OSS_SemCreate(OSS_HANDLE *osHdl, int32 semType, int32 initVal,
+						   OSS_SEM_HANDLE **semHandleP);
+extern int32 OSS_SemRemove(OSS_HANDLE *osHdl, OSS_SEM_HANDLE **semHandleP);
+extern int32 OSS_SemWait(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle,
+						 int32 msec);
+extern int32 OSS_SemSignal(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle);
+
+extern int32 OSS_MikroDelayInit(OSS_HANDLE *osHdl);
+extern int32 OSS_MikroDelay(OSS_HANDLE *osHdl, u_int32 usec);
+extern int32 OSS_Delay(OSS_HANDLE *osHdl, int32 msec);
+extern int32 OSS_TickRateGet(OSS_HANDLE *osHdl);
+extern u_int32 OSS_TickGet(OSS_HANDLE *osHdl);
+
+extern int32 OSS_AlarmCreate(OSS_HANDLE *osHdl, void (*funct)(void *arg),
+							 void *arg, OSS_ALARM_HANDLE **alarmP);
+extern int32 OSS_AlarmRemove(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE **alarmP);
+extern int32 OSS_AlarmSet(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm,
+						  u_int32 msec, u_int32 cyclic, u_int32 *realMsecP);
+extern int32 OSS_AlarmClear(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm);
+
+extern OSS_IRQ_STATE OSS_IrqMaskR(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHdl);
+extern void OSS_IrqRestore(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHdl,
+						   OSS_IRQ_STATE oldState);
+
+#endif /* _OSS_H */
@@ -0,0 +1,1860 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   M 5 8 _ S I M                    ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: see
+ *
+ *  Description: Run the M58 driver on the host simulator
+ *
+ *               Links the unmodified m58_drv.c against the register model
+ *               and the OSS/DESC/MBUF stand-ins (see sim.h). First the
+ *               checks are run (see G_check), then the benchmarks:
+ *
+ *               - irq cost: host time, cpu clock cycles (x86 only) and bus
+ *                 cycles per M58_Irq call for several channel
+ *                 configurations
+ *               - block read: host time and bus cycles per direct
+ *                 M58_BlockRead frame
+ *               - overrun: frames lost with a reader polling every 10 msec
+ *                 at several trigger rates
+ *
+ *               Like MDIS, the harness holds the device semaphore during
+ *               each driver call, so that the driver paths which release
+ *               the device while waiting are run as well.
+ *
+ *               The basic checks and the benchmarks only use entry points
+ *               and codes of the original driver, so older driver
+ *               revisions can be measured the same way (option -b, see
+ *               Makefile, DRV_SRC). The feature checks need the driver
+ *               of this tree.
+ *
+ *     Required: sim_hw.c sim_oss.c sim_desc.c sim_mbuf.c m58_drv.c
+ *     Switches: _ONE_NAMESPACE_PER_DRIVER_
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/m58_drv.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define CHECK(expr)		Check((expr), #expr, __LINE__)
+
+#define IN_BUF_SIZE		1024	/* input buffer size [bytes] */
+#define RD_PERIOD		10000	/* overrun test: reader period [usec] */
+#define RD_SIZE			256		/* overrun test: reader block size */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+/* check */
+typedef struct {
+	const char	*name;		/* description */
+	void		(*funct)(void);	/* check routine */
+	int			basic;		/* supported by the original driver */
+} CHECK_ENTRY;
+
+/* channel configuration */
+typedef struct {
+	const char	*name;		/* description */
+	u_int32		inMask;		/* input channels (bit 0..3 = A..D) */
+	u_int32		bufMask;	/* block i/o channels */
+} CH_CONFIG;
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+#ifdef _ONE_NAMESPACE_PER_DRIVER_
+extern void LL_GetEntry(LL_ENTRY *drvP);
+# define GET_ENTRY	LL_GetEntry
+#else
+extern void GetEntry(LL_ENTRY *drvP);
+# define GET_ENTRY	GetEntry
+#endif
+
+static void usage(void);
+static void Check(int ok, const char *expr, int line);
+static void DrvInit(void);
+static void DrvExit(void);
+static int DevLocked(void);
+static void WaitHook(void);
+static int32 SetStat(int32 ch, int32 code, INT32_OR_64 value);
+static int32 GetStat(int32 ch, int32 code, int32 *valueP);
+static int32 BlkSetStat(int32 code, void *data, int32 size);
+static int32 BlkGetStat(int32 code, void *data, int32 *sizeP);
+static void SetChannels(const CH_CONFIG *cfg);
+static void Trigger(u_int32 count);
+static void PatternCount(u_int32 n, u_int8 *pin);
+static double NsecNow(void);
+static double ClkNow(void);
+static void CheckBasic(void);
+static void CheckCtrlShadow(void);
+static void CheckRdSamples(void);
+static void CheckPlayback(void);
+static void CheckOutFifo(void);
+static void CheckTstamp(void);
+static void CheckStats(void);
+static void CheckChangeOnly(void);
+static void CheckEvents(void);
+static void CheckDebounce(void);
+static void CheckCounters(void);
+static void CheckPeriodic(void);
+static void CheckModeration(void);
+static void CheckSigCoalesce(void);
+static void CheckWaitTrig(void);
+static void CheckWindow(void);
+static void CheckMatch(void);
+static void CheckReflex(void);
+static void CheckCmdList(void);
+static void CheckOutMasks(void);
+static void CheckPortsAll(void);
+static void CheckIdCache(void);
+static void BenchIrq(u_int32 count);
+static void BenchBlockRead(u_int32 count);
+static void BenchOverrun(void);
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static LL_ENTRY			G_entry;
+static LL_HANDLE		*G_llHdl;
+static OSS_SEM_HANDLE	*G_devSem;
+static u_int8			G_maDummy;
+static int				G_failed;
+static SIM_TRIGGEN		G_hookGen;		/* triggers while driver waits */
+static u_int32			G_hookUnlocked;	/* waits with device released */
+
+static const CH_CONFIG G_chCfg[] = {
+	{ "A B C D in",	0x0f, 0x0f },
+	{ "A B in",		0x03, 0x03 },
+	{ "C D in",		0x0c, 0x0c },
+	{ "A C in",		0x05, 0x05 },
+	{ "A in",		0x01, 0x01 },
+	{ "A B in, C D out (not buffered)", 0x03, 0x03 },
+};
+
+static const CHECK_ENTRY G_check[] = {
+	{ "basic i/o",				CheckBasic,			TRUE },
+	{ "control shadow",			CheckCtrlShadow,	FALSE },
+	{ "multi-sample read",		CheckRdSamples,		FALSE },
+	{ "playback",				CheckPlayback,		FALSE },
+	{ "output fifo",			CheckOutFifo,		FALSE },
+	{ "timestamps",				CheckTstamp,		FALSE },
+	{ "statistics",				CheckStats,			FALSE },
+	{ "change-only capture",	CheckChangeOnly,	FALSE },
+	{ "edge events",			CheckEvents,		FALSE },
+	{ "debounce",				CheckDebounce,		FALSE },
+	{ "pulse counters",			CheckCounters,		FALSE },
+	{ "periodic sampling",		CheckPeriodic,		FALSE },
+	{ "irq moderation",			CheckModeration,	FALSE },
+	{ "signal coalescing",		CheckSigCoalesce,	FALSE },
+	{ "wait for triggers",		CheckWaitTrig,		FALSE },
+	{ "capture window",			CheckWindow,		FALSE },
+	{ "pattern match",			CheckMatch,			FALSE },
+	{ "reflex",					CheckReflex,		FALSE },
+	{ "command list",			CheckCmdList,		FALSE },
+	{ "output bit masks",		CheckOutMasks,		FALSE },
+	{ "all ports",				CheckPortsAll,		FALSE },
+	{ "id prom cache",			CheckIdCache,		FALSE },
+};
+
+/********************************* usage ************************************
+ *
+ *  Description: Print program usage
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void usage(void)
+{
+	printf("Usage: m58_sim [<opts>]\n");
+	printf("Function: Run the M58 driver on the host simulator\n");
+	printf("Options:\n");
+	printf("    -b           basic checks only (older drivers)\n");
+	printf("    -c           checks only (no benchmarks)\n");
+	printf("    -n=<n>       nr of irqs/frames per benchmark     [200000]\n");
+	printf("\n");
+}
+
+/********************************* main *************************************
+ *
+ *  Description: Program main function
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv	argument counter, data ..
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	u_int32 count = 200000;
+	int failed;
+	int checkOnly = 0, basicOnly = 0;
+	u_int32 n;
+
+	for (n=1; n<(u_int32)argc; n++) {
+		if (!strcmp(argv[n], "-b"))
+			basicOnly = 1;
+		else if (!strcmp(argv[n], "-c"))
+			checkOnly = 1;
+		else if (!strncmp(argv[n], "-n=", 3))
+			count = strtoul(argv[n] + 3, NULL, 0);
+		else {
+			usage();
+			return(1);
+		}
+	}
+
+	GET_ENTRY(&G_entry);
+
+	for (n=0; n<sizeof(G_check)/sizeof(G_check[0]); n++) {
+		if (basicOnly && !G_check[n].basic)
+			continue;
+
+		failed = G_failed;
+		G_check[n].funct();
+		if (G_failed != failed)
+			printf("*** %s: FAILED\n", G_check[n].name);
+	}
+	printf("checks: %s\n", G_failed ? "FAILED" : "ok");
+
+	if (!checkOnly && !G_failed) {
+		BenchIrq(count);
+		BenchBlockRead(count);
+		BenchOverrun();
+	}
+
+	return(G_failed ? 1 : 0);
+}
+
+/********************************* Check ************************************
+ *
+ *  Description: Report a failed check
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ok         check result
+ *               expr       checked expression
+ *               line       source line
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void Check(int ok, const char *expr, int line)
+{
+	if (!ok) {
+		printf("*** check failed (line %d): %s\n", line, expr);
+		G_failed++;
+	}
+}
+
+/******************************** DrvInit ***********************************
+ *
+ *  Description: Reset the register model and initialize the driver
+ *
+ *               The descriptor keys set via SIM_DescSet are used. The
+ *               device semaphore is created locked, i.e. held by the
+ *               harness as MDIS does during each driver call.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_llHdl, G_devSem
+ ****************************************************************************/
+static void DrvInit(void)
+{
+	MACCESS ma = &G_maDummy;
+	int32 error;
+
+	SIM_HwReset();
+
+	if (OSS_SemCreate(NULL, OSS_SEM_BIN, 0, &G_devSem)) {
+		printf("*** can't create device semaphore\n");
+		exit(1);
+	}
+
+	if ((error = G_entry.init(NULL, NULL, &ma, G_devSem, NULL,
+							  &G_llHdl))) {
+		printf("*** M58_Init failed: 0x%04x\n", (unsigned)error);
+		exit(1);
+	}
+}
+
+/******************************** DrvExit ***********************************
+ *
+ *  Description: De-initialize the driver
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_llHdl, G_devSem
+ ****************************************************************************/
+static void DrvExit(void)
+{
+	CHECK(G_entry.exit(&G_llHdl) == 0);
+	CHECK((SIM_Ctrl[3] & 0x08) == 0);	/* irq disabled */
+	CHECK(DevLocked());
+
+	OSS_SemRemove(NULL, &G_devSem);
+}
+
+/******************************* DevLocked **********************************
+ *
+ *  Description: Check that the device semaphore is (still) held
+ *
+ *               A driver which released the device while waiting must
+ *               have taken it again before returning.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     TRUE if locked
+ *  Globals....: G_devSem
+ ****************************************************************************/
+static int DevLocked(void)
+{
+	return( OSS_SemWait(NULL, G_devSem, OSS_SEM_NOWAIT) == ERR_OSS_TIMEOUT );
+}
+
+/******************************** WaitHook **********************************
+ *
+ *  Description: Blocking wait of the driver (see SIM_WaitHook)
+ *
+ *               Counts the waits with the device semaphore released and
+ *               runs the triggers of G_hookGen meanwhile.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_hookGen, G_hookUnlocked
+ ****************************************************************************/
+static void WaitHook(void)
+{
+	/* DevLocked() took the free semaphore: give it back */
+	if (!DevLocked()) {
+		OSS_SemSignal(NULL, G_devSem);
+		G_hookUnlocked++;
+	}
+
+	SIM_Trigger(&G_entry, G_llHdl, &G_hookGen);
+}
+
+/******************************** SetStat ***********************************
+ *
+ *  Description: Call M58_SetStat
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ch         channel
+ *               code       status code
+ *               value      value
+ *  Output.....: return     driver return value
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static int32 SetStat(int32 ch, int32 code, INT32_OR_64 value)
+{
+	return( G_entry.setStat(G_llHdl, code, ch, value) );
+}
+
+/******************************** GetStat ***********************************
+ *
+ *  Description: Call M58_GetStat
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ch         channel
+ *               code       status code
+ *  Output.....: return     driver return value
+ *               *valueP    value
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static int32 GetStat(int32 ch, int32 code, int32 *valueP)
+{
+	INT32_OR_64 value = 0;
+	int32 error;
+
+	error = G_entry.getStat(G_llHdl, code, ch, &value);
+	*valueP = (int32)value;
+	return(error);
+}
+
+/******************************* BlkSetStat *********************************
+ *
+ *  Description: Call M58_SetStat with a block status code
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: code       status code
+ *               data       data buffer
+ *               size       data size [bytes]
+ *  Output.....: return     driver return value
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static int32 BlkSetStat(int32 code, void *data, int32 size)
+{
+	M_SG_BLOCK blk;
+
+	blk.size = size;
+	blk.data = data;
+	return( G_entry.setStat(G_llHdl, code, 0, (INT32_OR_64)&blk) );
+}
+
+/******************************* BlkGetStat *********************************
+ *
+ *  Description: Call M58_GetStat with a block status code
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: code       status code
+ *               data       data buffer
+ *               *sizeP     data buffer size [bytes]
+ *  Output.....: return     driver return value
+ *               *sizeP     data size [bytes]
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static int32 BlkGetStat(int32 code, void *data, int32 *sizeP)
+{
+	M_SG_BLOCK blk;
+	int32 error;
+
+	blk.size = *sizeP;
+	blk.data = data;
+	error = G_entry.getStat(G_llHdl, code, 0, (INT32_OR_64*)&blk);
+	*sizeP = blk.size;
+	return(error);
+}
+
+/****************************** SetChannels *********************************
+ *
+ *  Description: Set direction and block i/o enable of all channels
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: cfg        channel configuration
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void SetChannels(const CH_CONFIG *cfg)
+{
+	int32 ch;
+
+	for (ch=0; ch<4; ch++) {
+		CHECK(SetStat(ch, M_LL_CH_DIR, (cfg->inMask & (1 << ch)) ?
+					  M_CH_IN : M_CH_OUT) == 0);
+		CHECK(SetStat(ch, M58_BUF_ENABLE,
+					  (cfg->bufMask & (1 << ch)) ? 1 : 0) == 0);
+	}
+}
+
+/******************************** Trigger ***********************************
+ *
+ *  Description: Generate triggers at 1 kHz with the current input levels
+ *
+ *               The interrupt must be enabled.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: count      nr of triggers
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Trigger(u_int32 count)
+{
+	SIM_TRIGGEN gen;
+
+	memset(&gen, 0, sizeof(gen));
+	gen.rate = 1000;
+	gen.count = count;
+	SIM_Trigger(&G_entry, G_llHdl, &gen);
+	CHECK(gen.irqCalled == count);
+}
+
+/****************************** PatternCount ********************************
+ *
+ *  Description: Trigger pattern: port A..D = n, n+1, n+2, n+3
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: n          trigger number
+ *               pin        input pins A..D
+ *  Output.....: pin        new pin levels
+ *  Globals....: -
+ ****************************************************************************/
+static void PatternCount(u_int32 n, u_int8 *pin)
+{
+	pin[0] = (u_int8)n;
+	pin[1] = (u_int8)(n + 1);
+	pin[2] = (u_int8)(n + 2);
+	pin[3] = (u_int8)(n + 3);
+}
+
+/******************************** NsecNow ***********************************
+ *
+ *  Description: Get host time
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     monotonic time [nsec]
+ *  Globals....: -
+ ****************************************************************************/
+static double NsecNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return( ts.tv_sec * 1e9 + ts.tv_nsec );
+}
+
+/********************************* ClkNow ***********************************
+ *
+ *  Description: Get cpu clock counter
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     time stamp counter (0 if not x86)
+ *  Globals....: -
+ ****************************************************************************/
+static double ClkNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return( (double)__builtin_ia32_rdtsc() );
+#else
+	return(0);
+#endif
+}
+
+/******************************* CheckBasic *********************************
+ *
+ *  Description: Basic checks of direct and buffered i/o
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckBasic(void)
+{
+	static const CH_CONFIG outBD = { "A C in, B D out", 0x05, 0x0f };
+	SIM_TRIGGEN gen;
+	u_int8 buf[IN_BUF_SIZE];
+	int32 value, nbr, n;
+
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 64);
+	DrvInit();
+
+	/* init: all inputs */
+	CHECK(SIM_Ctrl[0] == 0x0f);
+
+	/* direct read */
+	PatternCount(0x10, SIM_Pin);
+	for (n=0; n<4; n++)
+		CHECK(G_entry.read(G_llHdl, n, &value) == 0 && value == 0x10 + n);
+
+	/* direct block read: A..D */
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+	CHECK(nbr == 4 && buf[0] == 0x10 && buf[1] == 0x11 &&
+		  buf[2] == 0x12 && buf[3] == 0x13);
+
+	/* direct write/block write on B and D */
+	SetChannels(&outBD);
+	CHECK(G_entry.write(G_llHdl, 1, 0x5a) == 0 && SIM_PortOut(1) == 0x5a);
+	CHECK(G_entry.write(G_llHdl, 0, 0x5a) == ERR_LL_ILL_DIR);
+	buf[0] = 0xb1; buf[1] = 0xd1;
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf, 2, &nbr) == 0 && nbr == 2);
+	CHECK(SIM_PortOut(1) == 0xb1 && SIM_PortOut(3) == 0xd1);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+	CHECK(nbr == 2 && buf[0] == 0x10 && buf[1] == 0x12);
+
+	/* buffered input: 16 frames A..D, ring buffer holds 16 */
+	SetChannels(&G_chCfg[0]);
+	CHECK(SetStat(0, M_BUF_RD_MODE, M_BUF_RINGBUF) == 0);
+	CHECK(SetStat(0, M58_DATA_MODE, 5) == 0);
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	memset(&gen, 0, sizeof(gen));
+	gen.rate = 1000;
+	gen.count = 20;
+	gen.pattern = PatternCount;
+	SIM_BufOverrun = 0;
+	SIM_Trigger(&G_entry, G_llHdl, &gen);
+	CHECK(gen.irqCalled == 20 && SIM_Bus.irqAck >= 20);
+	CHECK(SIM_BufOverrun == 4);
+
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+	CHECK(nbr == 64);
+	for (n=0; n<16; n++)
+		CHECK(buf[n*4] == n && buf[n*4+1] == n + 1 &&
+			  buf[n*4+2] == n + 2 && buf[n*4+3] == n + 3);
+
+	/* irq disabled: no frames */
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 0) == 0);
+	memset(&gen, 0, sizeof(gen));
+	gen.rate = 1000;
+	gen.count = 5;
+	SIM_Trigger(&G_entry, G_llHdl, &gen);
+	CHECK(gen.irqCalled == 0 && gen.irqMasked == 5);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+	CHECK(nbr == 0);
+
+	DrvExit();
+}
+
+/**************************** CheckCtrlShadow *******************************
+ *
+ *  Description: Control register setstats/getstats without read cycles
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckCtrlShadow(void)
+{
+	int32 value;
+
+	SIM_DescClear();
+	DrvInit();
+
+	memset(&SIM_Bus, 0, sizeof(SIM_Bus));
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0 && SIM_Ctrl[3] == 0x08);
+	CHECK(SetStat(2, M_LL_CH_DIR, M_CH_OUT) == 0 && SIM_Ctrl[0] == 0x0b);
+	CHECK(SetStat(0, M58_DATA_MODE, 5) == 0);
+	CHECK(SetStat(0, M58_TRIG_EDGE, M58_TRIG_RISE) == 0);
+	CHECK(SIM_Ctrl[2] == 0x0d);
+	CHECK(SetStat(1, M58_PORT_TERM, M58_TERM_ACTIVE) == 0);
+	CHECK(SIM_Ctrl[1] == 0x0d);
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 0) == 0 && SIM_Ctrl[3] == 0x00);
+
+	CHECK(GetStat(0, M58_DATA_MODE, &value) == 0 && value == 5);
+	CHECK(GetStat(1, M58_PORT_TERM, &value) == 0 &&
+		  value == M58_TERM_ACTIVE);
+	CHECK(SIM_Bus.rdD16 == 0 && SIM_Bus.wrD16 == 6);
+
+	DrvExit();
+}
+
+/***************************** CheckRdSamples *******************************
+ *
+ *  Description: Direct block read of several paced frames
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckRdSamples(void)
+{
+	u_int8 buf[64];
+	int32 value, nbr, n;
+
+	SIM_DescClear();
+	DrvInit();
+	PatternCount(0x20, SIM_Pin);
+
+	/* default: one frame */
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+	CHECK(nbr == 4);
+
+	/* 0: as many frames as fit */
+	CHECK(SetStat(0, M58_RD_SAMPLES, 0) == 0);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, 63, &nbr) == 0 && nbr == 60);
+	for (n=0; n<15; n++)
+		CHECK(buf[n*4] == 0x20 && buf[n*4+3] == 0x23);
+
+	/* 5 frames, 10 usec apart */
+	SIM_DelayUs = SIM_DelayInit = 0;
+	CHECK(SetStat(0, M58_RD_SAMPLES, 5) == 0);
+	CHECK(SetStat(0, M58_RD_PACE, 10) == 0 && SIM_DelayInit == 1);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, 63, &nbr) == 0 && nbr == 20);
+	CHECK(SIM_DelayUs == 40);
+	CHECK(GetStat(0, M58_RD_SAMPLES, &value) == 0 && value == 5);
+
+	DrvExit();
+}
+
+/****************************** CheckPlayback *******************************
+ *
+ *  Description: Timed and triggered block write playback
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckPlayback(void)
+{
+	u_int8 buf[20];
+	int32 nbr, n;
+
+	SIM_DescClear();
+	DrvInit();
+	CHECK(SetStat(2, M_LL_CH_DIR, M_CH_OUT) == 0);
+	CHECK(SetStat(3, M_LL_CH_DIR, M_CH_OUT) == 0);
+
+	/* frames C/D = n/0x80+n */
+	for (n=0; n<10; n++) {
+		buf[n*2]   = (u_int8)n;
+		buf[n*2+1] = (u_int8)(0x80 + n);
+	}
+
+	/* timed: complete frames only, one D16 cycle per frame */
+	CHECK(SetStat(0, M58_WR_PLAYBACK, M58_PB_TIMED) == 0);
+	CHECK(SetStat(0, M58_WR_PACE, 100) == 0);
+	memset(&SIM_Bus, 0, sizeof(SIM_Bus));
+	SIM_DelayUs = 0;
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf, 11, &nbr) == 0 && nbr == 10);
+	CHECK(SIM_Bus.wrD16 == 5 && SIM_DelayUs == 400);
+	CHECK(SIM_PortOut(2) == 4 && SIM_PortOut(3) == 0x84);
+
+	/* triggered: one frame per trigger, device released while waiting */
+	CHECK(SetStat(0, M58_WR_PLAYBACK, M58_PB_TRIG) == 0);
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	SIM_WaitHook = WaitHook;
+	memset(&G_hookGen, 0, sizeof(G_hookGen));
+	G_hookGen.rate = 1000;
+	G_hookGen.count = 10;
+	G_hookUnlocked = 0;
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf, 20, &nbr) == 0 && nbr == 20);
+	CHECK(G_hookGen.irqCalled == 10 && G_hookUnlocked == 1);
+	CHECK(SIM_PortOut(2) == 9 && SIM_PortOut(3) == 0x89);
+	CHECK(DevLocked());
+
+	/* timeout after 3 triggers */
+	CHECK(SetStat(0, M58_WR_TIMEOUT, 10) == 0);
+	G_hookGen.count = 3;
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf, 20, &nbr) ==
+		  ERR_OSS_TIMEOUT && nbr == 6);
+	CHECK(SIM_PortOut(2) == 2 && DevLocked());
+	SIM_WaitHook = NULL;
+
+	DrvExit();
+}
+
+/****************************** CheckOutFifo ********************************
+ *
+ *  Description: Trigger-paced output from the output buffer
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckOutFifo(void)
+{
+	static const CH_CONFIG outABC = { "D in, A B C out", 0x08, 0x0f };
+	u_int8 buf[9];
+	int32 nbr, n;
+
+	/* 3 byte frames, 8 byte ring buffer (wraps) */
+	SIM_DescClear();
+	SIM_DescSet("OUT_BUF/SIZE", 8);
+	SIM_DescSet("OUT_BUF/MODE", M_BUF_RINGBUF);
+	DrvInit();
+	SetChannels(&outABC);
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	for (n=0; n<9; n++)
+		buf[n] = (u_int8)(n + 1);
+
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf, 6, &nbr) == 0 && nbr == 6);
+	Trigger(1);
+	CHECK(SIM_PortOut(0) == 1 && SIM_PortOut(1) == 2 && SIM_PortOut(2) == 3);
+
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf+6, 3, &nbr) == 0 && nbr == 3);
+	Trigger(1);
+	CHECK(SIM_PortOut(0) == 4 && SIM_PortOut(1) == 5 && SIM_PortOut(2) == 6);
+	Trigger(1);
+	CHECK(SIM_PortOut(0) == 7 && SIM_PortOut(1) == 8 && SIM_PortOut(2) == 9);
+
+	/* empty: outputs hold */
+	Trigger(1);
+	CHECK(SIM_PortOut(0) == 7 && SIM_PortOut(2) == 9);
+
+	/* direct mode: written at once, not drained by the irq */
+	CHECK(SetStat(0, M_BUF_WR_MODE, M_BUF_USRCTRL) == 0);
+	CHECK(G_entry.blockWrite(G_llHdl, 0, buf, 3, &nbr) == 0 && nbr == 3);
+	CHECK(SIM_PortOut(0) == 1 && SIM_PortOut(2) == 3);
+	Trigger(1);
+	CHECK(SIM_PortOut(0) == 1 && SIM_PortOut(2) == 3);
+
+	DrvExit();
+}
+
+/******************************* CheckTstamp ********************************
+ *
+ *  Description: Timestamped input records
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckTstamp(void)
+{
+	M58_TS_REC rec[4];
+	int32 value, nbr;
+
+	/* 3 records, channels A C D */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 3 * sizeof(M58_TS_REC));
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	DrvInit();
+	CHECK(SetStat(1, M58_BUF_ENABLE, 0) == 0);
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(SetStat(0, M58_BUF_TSTAMP, 1) == 0);
+	CHECK(GetStat(0, M58_BUF_RECSIZE, &value) == 0 && value == 12);
+
+	SIM_Pin[0] = 1; SIM_Pin[2] = 2; SIM_Pin[3] = 3;
+	Trigger(3);
+	CHECK(G_entry.blockRead(G_llHdl, 0, (u_int8*)rec, sizeof(rec),
+							&nbr) == 0 && nbr == 36);
+	CHECK(rec[0].seq == 0 && rec[1].seq == 1 && rec[2].seq == 2);
+	CHECK(rec[1].tick == rec[0].tick + 1 && rec[2].tick == rec[0].tick + 2);
+	CHECK(rec[0].tick == OSS_TickGet(NULL) - 2);
+	CHECK(rec[2].data[0] == 1 && rec[2].data[1] == 2 &&
+		  rec[2].data[2] == 3 && rec[2].data[3] == 0);
+
+	/* format change flushes */
+	Trigger(2);
+	CHECK(SetStat(0, M58_BUF_TSTAMP, 0) == 0);
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == 0);
+	Trigger(1);
+	CHECK(G_entry.blockRead(G_llHdl, 0, (u_int8*)rec, sizeof(rec),
+							&nbr) == 0 && nbr == 3);
+	DrvExit();
+
+	/* buffer size not a multiple of the record size */
+	SIM_DescSet("IN_BUF/SIZE", 40);
+	DrvInit();
+	CHECK(SetStat(0, M58_BUF_TSTAMP, 1) == ERR_LL_ILL_PARAM);
+	DrvExit();
+}
+
+/******************************** CheckStats ********************************
+ *
+ *  Description: Trigger, buffer and bus cycle statistics
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckStats(void)
+{
+	M58_STATS st;
+	int32 size;
+
+	/* 2 frames fit */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 8);
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(SetStat(0, M58_TRIG_SIG_SET, 5) == 0);
+
+	SIM_SigSent = 0;
+	Trigger(3);
+	size = sizeof(st);
+	CHECK(BlkGetStat(M58_BLK_STATS, &st, &size) == 0 &&
+		  size == sizeof(st));
+	CHECK(st.trigCount == 3 && st.stored == 2 && st.dropped == 1 &&
+		  st.partial == 0);
+	CHECK(st.sigSent == 3 && SIM_SigSent == 3 && st.fillMax == 8);
+	CHECK(st.busD16 == 6 && st.busD8 == 0);	/* 3 x port A/B, C/D */
+
+	CHECK(SetStat(0, M58_STATS_CLR, 0) == 0);
+	size = sizeof(st);
+	CHECK(BlkGetStat(M58_BLK_STATS, &st, &size) == 0);
+	CHECK(st.trigCount == 0 && st.stored == 0 && st.busD16 == 0);
+
+	size = sizeof(st) - 1;
+	CHECK(BlkGetStat(M58_BLK_STATS, &st, &size) == ERR_LL_USERBUF);
+
+	DrvExit();
+}
+
+/***************************** CheckChangeOnly ******************************
+ *
+ *  Description: Store changed input frames only
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckChangeOnly(void)
+{
+	M58_TS_REC rec[8];
+	int32 value, nbr;
+
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 10 * sizeof(M58_TS_REC));
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(SetStat(0, M58_BUF_CAPTURE, M58_CAPT_CHANGE) == 0);
+	CHECK(GetStat(0, M58_BUF_RECSIZE, &value) == 0 && value == 12);
+
+	PatternCount(1, SIM_Pin);
+	Trigger(3);						/* seq 0 stored */
+	SIM_Pin[3] = 5;
+	Trigger(2);						/* seq 3 stored */
+	CHECK(SetStat(0, M58_CAPT_MASK, 0xff) == 0);
+	Trigger(1);						/* seq 5 stored (new mask) */
+	SIM_Pin[3] = 6;
+	Trigger(1);						/* masked out */
+	SIM_Pin[0] = 0;
+	Trigger(1);						/* seq 7 stored */
+
+	CHECK(G_entry.blockRead(G_llHdl, 0, (u_int8*)rec, sizeof(rec),
+							&nbr) == 0 && nbr == 4 * 12);
+	CHECK(rec[0].seq == 0 && rec[0].data[0] == 1 && rec[0].data[3] == 4);
+	CHECK(rec[1].seq == 3 && rec[1].data[3] == 5);
+	CHECK(rec[2].seq == 5);
+	CHECK(rec[3].seq == 7 && rec[3].data[0] == 0 && rec[3].data[3] == 6);
+
+	CHECK(SetStat(0, M58_BUF_CAPTURE, M58_CAPT_ALL) == 0);
+	CHECK(GetStat(0, M58_BUF_RECSIZE, &value) == 0 && value == 4);
+
+	DrvExit();
+}
+
+/******************************* CheckEvents ********************************
+ *
+ *  Description: Edge event queue
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckEvents(void)
+{
+	M58_EVT_REC ev[8];
+	int32 value, nbr, ch;
+
+	SIM_DescClear();
+	SIM_DescSet("EVT_BUF/SIZE", 6 * sizeof(M58_EVT_REC));
+	SIM_DescSet("EVT_BUF/MASK", 0x0000ff81);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	SIM_Pin[0] = 0x01;
+	Trigger(1);						/* first frame: no events */
+	SIM_Pin[0] = 0x80; SIM_Pin[1] = 0x03;
+	Trigger(1);						/* bit 0 fall, bit 7,8,9 rise */
+	SIM_Pin[0] = 0x02;
+	Trigger(1);						/* bit 1 masked out, bit 7 fall */
+
+	CHECK(SetStat(0, M58_RD_SOURCE, M58_SRC_EVENTS) == 0);
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == 60);
+	CHECK(G_entry.blockRead(G_llHdl, 0, (u_int8*)ev, sizeof(ev),
+							&nbr) == 0 && nbr == 60);
+	CHECK(ev[0].bit == 0 && ev[0].edge == M58_EDGE_FALL && ev[0].seq == 1);
+	CHECK(ev[1].bit == 7 && ev[1].edge == M58_EDGE_RISE);
+	CHECK(ev[2].bit == 8 && ev[3].bit == 9 && ev[3].edge == M58_EDGE_RISE);
+	CHECK(ev[4].bit == 7 && ev[4].edge == M58_EDGE_FALL && ev[4].seq == 2);
+	CHECK(ev[4].tick == ev[0].tick + 1);
+
+	/* channel not enabled for block i/o */
+	for (ch=0; ch<4; ch++)
+		CHECK(SetStat(ch, M58_BUF_ENABLE, 0) == 0);
+	CHECK(SetStat(0, M58_EVT_MASK, 0x00010000) == 0);
+	Trigger(1);						/* new mask: no events */
+	SIM_Pin[2] = 0x01;
+	Trigger(1);
+	SIM_Pin[2] = 0x00;
+	Trigger(1);
+	CHECK(G_entry.blockRead(G_llHdl, 0, (u_int8*)ev, sizeof(ev),
+							&nbr) == 0 && nbr == 24);
+	CHECK(ev[0].bit == 16 && ev[0].edge == M58_EDGE_RISE);
+	CHECK(ev[1].bit == 16 && ev[1].edge == M58_EDGE_FALL);
+
+	DrvExit();
+}
+
+/****************************** CheckDebounce *******************************
+ *
+ *  Description: Debounce filter of buffered and direct input
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckDebounce(void)
+{
+	u_int8 buf[20];
+	int32 value, nbr;
+
+	/* A bit 0..3: 3 stable samples, D: 2 stable samples */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", sizeof(buf));
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	SIM_DescSet("CHANNEL_0/DEBOUNCE", 3);
+	SIM_DescSet("CHANNEL_0/DEBOUNCE_MASK", 0x0f);
+	SIM_DescSet("CHANNEL_3/DEBOUNCE", 2);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(GetStat(0, M58_DEBOUNCE, &value) == 0 && value == 3);
+	CHECK(GetStat(0, M58_DEBOUNCE_MASK, &value) == 0 && value == 0x0f);
+
+	Trigger(1);									/* stable 0 */
+	SIM_Pin[0] = 0x11; SIM_Pin[3] = 0x80;
+	Trigger(1);									/* A bit 4 not filtered */
+	SIM_Pin[0] = 0x01; SIM_Pin[3] = 0x00;
+	Trigger(1);									/* D bounces */
+	SIM_Pin[3] = 0x80;
+	Trigger(1);									/* A bit 0 stable */
+	Trigger(1);									/* D stable */
+
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0 &&
+		  nbr == 20);
+	CHECK(buf[0] == 0x00 && buf[4] == 0x10 && buf[7] == 0x00);
+	CHECK(buf[8] == 0x00 && buf[11] == 0x00);
+	CHECK(buf[12] == 0x01 && buf[15] == 0x00);
+	CHECK(buf[16] == 0x01 && buf[19] == 0x80);
+
+	/* direct read shares the filter */
+	SIM_Pin[0] = 0x00;
+	CHECK(G_entry.read(G_llHdl, 0, &value) == 0 && value == 0x01);
+	CHECK(G_entry.read(G_llHdl, 0, &value) == 0 && value == 0x01);
+	CHECK(G_entry.read(G_llHdl, 0, &value) == 0 && value == 0x00);
+
+	/* filter off */
+	SIM_Pin[0] = 0x01;
+	CHECK(SetStat(0, M58_DEBOUNCE, 0) == 0);
+	CHECK(G_entry.read(G_llHdl, 0, &value) == 0 && value == 0x01);
+
+	DrvExit();
+}
+
+/****************************** CheckCounters *******************************
+ *
+ *  Description: Pulse counters
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckCounters(void)
+{
+	M58_COUNTERS cnt;
+	int32 size, n;
+
+	SIM_DescClear();
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(SetStat(0, M58_CNT_RISE, 0x80000001) == 0);
+	CHECK(SetStat(0, M58_CNT_FALL, 0x00000101) == 0);
+
+	/* 5 pulses on A bit 0, B bit 0, D bit 7 */
+	Trigger(1);
+	for (n=0; n<5; n++) {
+		SIM_Pin[0] = 0x01; SIM_Pin[1] = 0x01; SIM_Pin[3] = 0x80;
+		Trigger(1);
+		SIM_Pin[0] = 0x00; SIM_Pin[1] = 0x00; SIM_Pin[3] = 0x00;
+		Trigger(1);
+	}
+
+	size = sizeof(cnt);
+	CHECK(BlkGetStat(M58_BLK_COUNTERS_CLR, &cnt, &size) == 0 &&
+		  size == sizeof(cnt));
+	CHECK(cnt.count[0] == 10 && cnt.count[8] == 5 && cnt.count[31] == 5);
+	CHECK(cnt.count[1] == 0 && cnt.count[7] == 0);
+	size = sizeof(cnt);
+	CHECK(BlkGetStat(M58_BLK_COUNTERS, &cnt, &size) == 0);
+	CHECK(cnt.count[0] == 0 && cnt.count[31] == 0);
+
+	/* channel not enabled for block i/o */
+	for (n=0; n<4; n++)
+		CHECK(SetStat(n, M58_BUF_ENABLE, 0) == 0);
+	CHECK(SetStat(0, M58_CNT_RISE, 0x00010000) == 0);
+	Trigger(1);
+	for (n=0; n<3; n++) {
+		SIM_Pin[2] = 0x01;
+		Trigger(1);
+		SIM_Pin[2] = 0x00;
+		Trigger(1);
+	}
+	size = sizeof(cnt);
+	CHECK(BlkGetStat(M58_BLK_COUNTERS, &cnt, &size) == 0);
+	CHECK(cnt.count[16] == 3);
+
+	size = sizeof(cnt) - 4;
+	CHECK(BlkGetStat(M58_BLK_COUNTERS, &cnt, &size) == ERR_LL_USERBUF);
+
+	DrvExit();
+}
+
+/****************************** CheckPeriodic *******************************
+ *
+ *  Description: Timer driven sampling without trigger
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckPeriodic(void)
+{
+	M58_TS_REC rec[4];
+	int32 value, nbr;
+
+	/* every 10 msec, irq disabled */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 4 * sizeof(M58_TS_REC));
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	SIM_DescSet("IN_BUF/TIMESTAMP", 1);
+	SIM_DescSet("IN_BUF/PERIOD", 10);
+	DrvInit();
+	CHECK(GetStat(0, M58_SMP_PERIOD, &value) == 0 && value == 10);
+
+	SIM_Pin[0] = 0x05;
+	SIM_Advance(35000);
+	CHECK(G_entry.blockRead(G_llHdl, 0, (u_int8*)rec, sizeof(rec),
+							&nbr) == 0 && nbr == 36);
+	CHECK(rec[0].seq == 0 && rec[2].seq == 2 && rec[1].data[0] == 0x05);
+	CHECK(rec[1].tick == rec[0].tick + 10 && rec[2].tick == rec[0].tick + 20);
+	CHECK(GetStat(0, M58_SMP_MISSED, &value) == 0 && value == 0);
+
+	/* stopped */
+	CHECK(SetStat(0, M58_SMP_PERIOD, 0) == 0);
+	SIM_Advance(50000);
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == 0);
+
+	DrvExit();
+}
+
+/***************************** CheckModeration ******************************
+ *
+ *  Description: Switch to polled mode under a trigger storm and back
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckModeration(void)
+{
+	SIM_TRIGGEN gen;
+	M58_STATS st;
+	int32 value, size;
+
+	/* max. 3 triggers per 10 msec, hold polled mode for 2 periods */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 400);
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	SIM_DescSet("IRQ_MOD/THRESHOLD", 3);
+	SIM_DescSet("IRQ_MOD/HOLD", 2);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	/* 5 triggers within the first period: 4th disables the irq */
+	memset(&gen, 0, sizeof(gen));
+	gen.rate = 1000;
+	gen.count = 5;
+	SIM_Trigger(&G_entry, G_llHdl, &gen);
+	CHECK(gen.irqCalled == 4 && gen.irqMasked == 1);
+	CHECK(GetStat(0, M58_MOD_POLLED, &value) == 0 && value == 1);
+	CHECK((SIM_Ctrl[3] & 0x08) == 0);
+
+	/* user can't re-enable while polled */
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0 && (SIM_Ctrl[3] & 0x08) == 0);
+
+	/* polled for 2 periods (one frame each), then irq again */
+	SIM_Advance(20000);
+	CHECK(GetStat(0, M58_MOD_POLLED, &value) == 0 && value == 0);
+	CHECK(SIM_Ctrl[3] & 0x08);
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == (4+2) * 4);
+
+	size = sizeof(st);
+	CHECK(BlkGetStat(M58_BLK_STATS, &st, &size) == 0);
+	CHECK(st.modPoll == 1 && st.trigCount == 4);
+
+	/* switched off while polled: irq at once */
+	gen.irqCalled = gen.irqMasked = 0;
+	SIM_Trigger(&G_entry, G_llHdl, &gen);
+	CHECK(gen.irqCalled == 4 && (SIM_Ctrl[3] & 0x08) == 0);
+	CHECK(SetStat(0, M58_MOD_THRESH, 0) == 0 && (SIM_Ctrl[3] & 0x08));
+
+	DrvExit();
+}
+
+/***************************** CheckSigCoalesce *****************************
+ *
+ *  Description: Trigger signal every n triggers, min. interval, fill level
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckSigCoalesce(void)
+{
+	SIM_TRIGGEN gen;
+	u_int8 buf[40];
+	int32 value, nbr;
+
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", sizeof(buf));
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(SetStat(0, M58_TRIG_SIG_SET, 5) == 0);
+
+	/* every 4th trigger */
+	CHECK(SetStat(0, M58_SIG_EVERY, 4) == 0);
+	SIM_SigSent = 0;
+	Trigger(10);
+	CHECK(SIM_SigSent == 2);
+	CHECK(GetStat(0, M58_SIG_PENDING, &value) == 0 && value == 2);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+
+	/* 3 triggers 3 msec apart, min. 5 msec between signals */
+	CHECK(SetStat(0, M58_SIG_EVERY, 0) == 0);
+	CHECK(SetStat(0, M58_SIG_MINTIME, 5000) == 0);
+	memset(&gen, 0, sizeof(gen));
+	gen.rate = 333;
+	gen.count = 3;
+	SIM_SigSent = 0;
+	SIM_Trigger(&G_entry, G_llHdl, &gen);
+	CHECK(gen.irqCalled == 3 && SIM_SigSent == 2);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+
+	/* once per 3 frames (12 bytes) in the buffer */
+	CHECK(SetStat(0, M58_SIG_MINTIME, 0) == 0);
+	CHECK(SetStat(0, M58_SIG_FILL, 12) == 0);
+	SIM_SigSent = 0;
+	Trigger(2);
+	CHECK(SIM_SigSent == 0);
+	Trigger(2);
+	CHECK(SIM_SigSent == 1);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0);
+	Trigger(3);
+	CHECK(SIM_SigSent == 2);
+
+	DrvExit();
+}
+
+/****************************** CheckWaitTrig *******************************
+ *
+ *  Description: Wait for triggers or input buffer fill level
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckWaitTrig(void)
+{
+	M58_WAIT wait;
+	int32 size;
+
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 400);
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	SIM_WaitHook = WaitHook;
+	memset(&G_hookGen, 0, sizeof(G_hookGen));
+	G_hookGen.rate = 1000;
+	G_hookUnlocked = 0;
+
+	/* 3 triggers, device released while waiting */
+	memset(&wait, 0, sizeof(wait));
+	wait.count = 3;
+	G_hookGen.count = 3;
+	size = sizeof(wait);
+	CHECK(BlkGetStat(M58_BLK_WAIT_TRIG, &wait, &size) == 0 &&
+		  size == sizeof(wait));
+	CHECK(wait.trigCount == 3 && wait.elapsed == 3);
+	CHECK(G_hookUnlocked == 1 && DevLocked());
+
+	/* too few triggers: timeout */
+	wait.count = 5;
+	wait.tout = 10;
+	G_hookGen.count = 2;
+	CHECK(BlkGetStat(M58_BLK_WAIT_TRIG, &wait, &size) == ERR_OSS_TIMEOUT);
+	CHECK(wait.trigCount == 5 && DevLocked());
+
+	/* fill level: 5 frames already there, 2 more needed */
+	wait.count = 0;
+	wait.tout = 0;
+	wait.fill = 5 * 4;
+	G_hookGen.count = 0;
+	CHECK(BlkGetStat(M58_BLK_WAIT_TRIG, &wait, &size) == 0);
+	wait.fill = 7 * 4;
+	G_hookGen.count = 2;
+	CHECK(BlkGetStat(M58_BLK_WAIT_TRIG, &wait, &size) == 0);
+	CHECK(wait.trigCount == 7 && DevLocked());
+	SIM_WaitHook = NULL;
+
+	size = sizeof(wait) - 1;
+	CHECK(BlkGetStat(M58_BLK_WAIT_TRIG, &wait, &size) == ERR_LL_USERBUF);
+
+	DrvExit();
+}
+
+/******************************* CheckWindow ********************************
+ *
+ *  Description: Pre-/post-trigger capture window
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckWindow(void)
+{
+	u_int8 buf[64];
+	int32 value, nbr, n;
+
+	/* 3 records before, 2 from the firing sample on */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	SIM_DescSet("WINDOW/PRE", 3);
+	SIM_DescSet("WINDOW/POST", 2);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(GetStat(0, M58_WIN_DEPTH, &value) == 0 && value == 5);
+	CHECK(SetStat(0, M58_WIN_PRE, 4) == ERR_LL_ILL_PARAM);
+
+	/* fire on A bit 0 high */
+	CHECK(SetStat(0, M58_WIN_MASK, 0x01) == 0);
+	CHECK(SetStat(0, M58_WIN_VALUE, 0x01) == 0);
+	CHECK(SetStat(0, M58_WIN_ARM, 1) == 0);
+	CHECK(GetStat(0, M58_WIN_ARM, &value) == 0 && value == M58_WIN_ARMED);
+	CHECK(SetStat(0, M58_WIN_PRE, 1) == ERR_LL_DEV_BUSY);
+	CHECK(SetStat(0, M58_RD_SOURCE, M58_SRC_WINDOW) == 0);
+
+	for (n=0; n<6; n++) {
+		SIM_Pin[0] = (u_int8)(0x10 + n * 2);
+		Trigger(1);
+	}
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0 &&
+		  nbr == 0);
+
+	SIM_Pin[0] = 0x21;
+	Trigger(1);
+	CHECK(GetStat(0, M58_WIN_ARM, &value) == 0 && value == M58_WIN_FIRED);
+	SIM_Pin[0] = 0x23;
+	Trigger(1);
+	CHECK(GetStat(0, M58_WIN_ARM, &value) == 0 && value == M58_WIN_DONE);
+	SIM_Pin[0] = 0x25;
+	Trigger(1);									/* frozen */
+
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, 19, &nbr) == ERR_LL_USERBUF);
+	CHECK(G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr) == 0 &&
+		  nbr == 5 * 4);
+	CHECK(buf[0] == 0x16 && buf[4] == 0x18 && buf[8] == 0x1a);
+	CHECK(buf[12] == 0x21 && buf[16] == 0x23);
+	CHECK(GetStat(0, M58_WIN_ARM, &value) == 0 && value == M58_WIN_IDLE);
+
+	/* input buffer is independent */
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == 8);
+
+	DrvExit();
+}
+
+/******************************** CheckMatch ********************************
+ *
+ *  Description: Pattern match table
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckMatch(void)
+{
+	M58_MATCH mat[2];
+	int32 value, size, ch;
+
+	/* store and signal if A bit 1..0 = 01 */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/SIZE", 400);
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	SIM_DescSet("MATCH/MODE", M58_MATCH_STORE | M58_MATCH_SIG);
+	SIM_DescSet("MATCH/MASK_0", 0x03);
+	SIM_DescSet("MATCH/VALUE_0", 0x01);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+	CHECK(SetStat(0, M58_TRIG_SIG_SET, 5) == 0);
+
+	size = sizeof(mat);
+	CHECK(BlkGetStat(M58_BLK_MATCH, mat, &size) == 0 && size == 8);
+	CHECK(mat[0].mask == 0x03 && mat[0].value == 0x01);
+
+	SIM_SigSent = 0;
+	SIM_Pin[0] = 0x00;
+	Trigger(1);
+	SIM_Pin[0] = 0x01;
+	Trigger(2);
+	SIM_Pin[0] = 0x03;
+	Trigger(1);
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == 2 * 4);
+	CHECK(SIM_SigSent == 2);
+	CHECK(GetStat(0, M58_MATCH_HITS, &value) == 0 && value == 2);
+
+	/* two entries, transitions into match only */
+	mat[1].mask = 0x80;
+	mat[1].value = 0x80;
+	CHECK(BlkSetStat(M58_BLK_MATCH, mat, sizeof(mat)) == 0);
+	CHECK(SetStat(0, M58_MATCH_MODE, M58_MATCH_STORE | M58_MATCH_EDGE) == 0);
+	SIM_Pin[0] = 0x01;
+	Trigger(2);									/* hit */
+	SIM_Pin[0] = 0x81;
+	Trigger(1);									/* still matching */
+	SIM_Pin[0] = 0x00;
+	Trigger(1);
+	SIM_Pin[0] = 0x80;
+	Trigger(1);									/* hit */
+	CHECK(GetStat(0, M_BUF_RD_COUNT, &value) == 0 && value == 4 * 4);
+	CHECK(BlkSetStat(M58_BLK_MATCH, mat, 7) == ERR_LL_ILL_PARAM);
+
+	/* signal only, on a channel not enabled for block i/o */
+	for (ch=0; ch<4; ch++)
+		CHECK(SetStat(ch, M58_BUF_ENABLE, 0) == 0);
+	mat[0].mask = 0x00010000;
+	mat[0].value = 0x00010000;
+	CHECK(BlkSetStat(M58_BLK_MATCH, mat, sizeof(mat[0])) == 0);
+	CHECK(SetStat(0, M58_MATCH_MODE, M58_MATCH_SIG) == 0);
+	SIM_SigSent = 0;
+	SIM_Pin[2] = 0x01;
+	Trigger(2);
+	SIM_Pin[2] = 0x00;
+	Trigger(1);
+	CHECK(SIM_SigSent == 2);
+
+	DrvExit();
+}
+
+/******************************* CheckReflex ********************************
+ *
+ *  Description: Input to output reflex rules
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckReflex(void)
+{
+	M58_REFLEX rfl[3];
+	u_int32 hits[3];
+	int32 size;
+
+	/* D out */
+	SIM_DescClear();
+	SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+	SIM_DescSet("CHANNEL_3/PORT_DIR", 0);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	/* D bit 4 follows A bit 0, D bit 0 toggles on A bit 1 rising */
+	memset(rfl, 0, sizeof(rfl));
+	rfl[0].mask = 0x01; rfl[0].value = 0x01;
+	rfl[0].port = 3; rfl[0].action = M58_RFL_SET; rfl[0].data = 0x10;
+	rfl[1].mask = 0x01; rfl[1].value = 0x00;
+	rfl[1].port = 3; rfl[1].action = M58_RFL_CLR; rfl[1].data = 0x10;
+	rfl[2].mask = 0x02; rfl[2].value = 0x02;
+	rfl[2].port = 3; rfl[2].action = M58_RFL_XOR | M58_RFL_EDGE;
+	rfl[2].data = 0x01;
+	rfl[0].port = 4;							/* no channel */
+	CHECK(BlkSetStat(M58_BLK_REFLEX, rfl, sizeof(rfl)) == ERR_LL_ILL_PARAM);
+	rfl[0].port = 3;
+	CHECK(BlkSetStat(M58_BLK_REFLEX, rfl, sizeof(rfl)) == 0);
+
+	CHECK(G_entry.write(G_llHdl, 3, 0x80) == 0);
+	SIM_Pin[0] = 0x01;
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x90);
+	SIM_Pin[0] = 0x03;
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x91);
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x91);
+	SIM_Pin[0] = 0x00;
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x81);
+	SIM_Pin[0] = 0x02;
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x80);
+
+	size = sizeof(hits);
+	CHECK(BlkGetStat(M58_BLK_REFLEX_HITS, hits, &size) == 0 && size == 12);
+	CHECK(hits[0] == 3 && hits[1] == 2 && hits[2] == 2);
+
+	/* condition on channels not enabled for block i/o */
+	memset(rfl, 0, sizeof(rfl));
+	rfl[0].mask = 0x00010001; rfl[0].value = 0x00010001;
+	rfl[0].port = 3; rfl[0].action = M58_RFL_WRITE; rfl[0].data = 0x42;
+	CHECK(BlkSetStat(M58_BLK_REFLEX, rfl, sizeof(rfl[0])) == 0);
+	CHECK(SetStat(2, M58_BUF_ENABLE, 0) == 0);
+	SIM_Pin[0] = 0x01; SIM_Pin[2] = 0x01;
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x42);
+
+	/* no rules */
+	CHECK(BlkSetStat(M58_BLK_REFLEX, rfl, 0) == 0);
+	CHECK(G_entry.write(G_llHdl, 3, 0x00) == 0);
+	Trigger(1);
+	CHECK(SIM_PortOut(3) == 0x00);
+
+	DrvExit();
+}
+
+/****************************** CheckCmdList ********************************
+ *
+ *  Description: Command list execution
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckCmdList(void)
+{
+	M58_CMD cmd[6];
+	int32 size;
+
+	/* D out */
+	SIM_DescClear();
+	SIM_DescSet("CHANNEL_3/PORT_DIR", 0);
+	DrvInit();
+	CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+	memset(cmd, 0, sizeof(cmd));
+	cmd[0].op = M58_CMD_WRITE;		cmd[0].ch = 3;	cmd[0].arg = 0x81;
+	cmd[1].op = M58_CMD_SETBITS;	cmd[1].ch = 3;	cmd[1].arg = 0x06;
+	cmd[2].op = M58_CMD_CLRBITS;	cmd[2].ch = 3;	cmd[2].arg = 0x01;
+	cmd[3].op = M58_CMD_DELAY_US;					cmd[3].arg = 5;
+	cmd[4].op = M58_CMD_READ;		cmd[4].ch = 0;
+	cmd[5].op = M58_CMD_WAIT_TRIG;					cmd[5].arg = 10;
+	SIM_Pin[0] = 0x5a;
+
+	/* trailing wait: device released while waiting */
+	SIM_WaitHook = WaitHook;
+	memset(&G_hookGen, 0, sizeof(G_hookGen));
+	G_hookGen.rate = 1000;
+	G_hookGen.count = 1;
+	G_hookUnlocked = 0;
+	SIM_DelayUs = SIM_DelayInit = 0;
+	size = sizeof(cmd);
+	CHECK(BlkGetStat(M58_BLK_CMDLIST, cmd, &size) == 0 &&
+		  size == sizeof(cmd));
+	CHECK(cmd[0].result == 0x81 && cmd[1].result == 0x87 &&
+		  cmd[2].result == 0x86 && cmd[4].result == 0x5a &&
+		  cmd[5].result == 1);
+	CHECK(SIM_PortOut(3) == 0x86 && SIM_DelayUs == 5);
+	CHECK(G_hookUnlocked == 1 && DevLocked());
+	SIM_WaitHook = NULL;
+
+	/* wait not last: rejected, nothing executed */
+	cmd[4] = cmd[5];
+	cmd[5].op = M58_CMD_READ;
+	size = sizeof(cmd);
+	CHECK(BlkGetStat(M58_BLK_CMDLIST, cmd, &size) == ERR_LL_ILL_PARAM &&
+		  size == 0);
+	CHECK(SIM_DelayUs == 5);
+
+	/* stops at first error: delay too long */
+	cmd[3].arg = M58_CMD_DELAY_MAX + 1;
+	size = 4 * sizeof(M58_CMD);
+	CHECK(BlkGetStat(M58_BLK_CMDLIST, cmd, &size) == ERR_LL_ILL_PARAM &&
+		  size == 3 * sizeof(M58_CMD));
+
+	/* set bits of an input */
+	cmd[0].op = M58_CMD_SETBITS;
+	cmd[0].ch = 0;
+	size = sizeof(M58_CMD);
+	CHECK(BlkGetStat(M58_BLK_CMDLIST, cmd, &size) == ERR_LL_ILL_DIR &&
+		  size == 0);
+
+	/* delay initialized once per handle */
+	CHECK(SIM_DelayInit == 1);
+
+	DrvExit();
+}
+
+/****************************** CheckOutMasks *******************************
+ *
+ *  Description: Set/clear/toggle output bits, only changed ports written
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckOutMasks(void)
+{
+	SIM_BUS *bus = &SIM_Bus;
+
+	/* B D out */
+	SIM_DescClear();
+	SIM_DescSet("CHANNEL_1/PORT_DIR", 0);
+	SIM_DescSet("CHANNEL_3/PORT_DIR", 0);
+	DrvInit();
+	CHECK(G_entry.write(G_llHdl, 1, 0x0f) == 0);
+
+	memset(bus, 0, sizeof(*bus));
+	CHECK(SetStat(0, M58_OUT_SET_MASK, 0x80001000) == 0);
+	CHECK(SIM_PortOut(1) == 0x1f && SIM_PortOut(3) == 0x80);
+	CHECK(bus->rdD8 + bus->rdD16 == 0 && bus->wrD8 + bus->wrD16 == 2);
+
+	memset(bus, 0, sizeof(*bus));
+	CHECK(SetStat(0, M58_OUT_CLR_MASK, 0x00000f00) == 0);
+	CHECK(SIM_PortOut(1) == 0x10 && SIM_PortOut(3) == 0x80);
+	CHECK(bus->wrD8 + bus->wrD16 == 1);
+
+	memset(bus, 0, sizeof(*bus));
+	CHECK(SetStat(0, M58_OUT_TOGGLE_MASK, 0x81000000) == 0);
+	CHECK(SIM_PortOut(1) == 0x10 && SIM_PortOut(3) == 0x01);
+	CHECK(bus->wrD8 + bus->wrD16 == 1);
+
+	/* no change: no write */
+	memset(bus, 0, sizeof(*bus));
+	CHECK(SetStat(0, M58_OUT_SET_MASK, 0x01000000) == 0);
+	CHECK(bus->wrD8 + bus->wrD16 == 0);
+
+	/* input bit */
+	CHECK(SetStat(0, M58_OUT_SET_MASK, 0x00000001) == ERR_LL_ILL_DIR);
+
+	DrvExit();
+}
+
+/****************************** CheckPortsAll *******************************
+ *
+ *  Description: 32-bit access of all ports
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckPortsAll(void)
+{
+	int32 value;
+
+	/* B out */
+	SIM_DescClear();
+	SIM_DescSet("CHANNEL_1/PORT_DIR", 0);
+	DrvInit();
+
+	/* only output channels are written */
+	SIM_Pin[0] = 0x11; SIM_Pin[2] = 0x33; SIM_Pin[3] = 0x44;
+	CHECK(SetStat(0, M58_PORTS_ALL, (INT32_OR_64)0xdeadbeef) == 0);
+	CHECK(SIM_PortOut(1) == 0xbe && SIM_Latch[0] != 0xef);
+
+	/* one read cycle per port pair (B from output shadow) */
+	memset(&SIM_Bus, 0, sizeof(SIM_Bus));
+	CHECK(GetStat(0, M58_PORTS_ALL, &value) == 0 &&
+		  (u_int32)value == 0x4433be11);
+	CHECK(SIM_Bus.rdD8 + SIM_Bus.rdD16 == 2);
+
+	DrvExit();
+}
+
+/****************************** CheckIdCache ********************************
+ *
+ *  Description: Id prom cache
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+static void CheckIdCache(void)
+{
+	u_int16 id[64];
+	int32 size;
+
+	/* cached at init */
+	SIM_DescClear();
+	DrvInit();
+	SIM_IdProm[5] = 0x1234;
+	size = sizeof(id);
+	CHECK(BlkGetStat(M_LL_BLK_ID_DATA, id, &size) == 0);
+	CHECK(id[0] == 0x5346 && id[1] == 58 && id[5] == 0x0000);
+
+	CHECK(SetStat(0, M58_ID_REFRESH, 0) == 0);
+	size = sizeof(id);
+	CHECK(BlkGetStat(M_LL_BLK_ID_DATA, id, &size) == 0 && id[5] == 0x1234);
+	DrvExit();
+
+	/* cache disabled: read from the prom */
+	SIM_DescSet("ID_CACHE", 0);
+	DrvInit();
+	SIM_IdProm[5] = 0x4321;
+	size = sizeof(id);
+	CHECK(BlkGetStat(M_LL_BLK_ID_DATA, id, &size) == 0 && id[5] == 0x4321);
+	DrvExit();
+}
+
+/******************************** BenchIrq **********************************
+ *
+ *  Description: Measure M58_Irq cost per channel configuration
+ *
+ *               The input buffer overwrites old frames, so that every irq
+ *               stores a frame.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: count      nr of irqs per configuration
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void BenchIrq(u_int32 count)
+{
+	SIM_BUS *bus = &SIM_Bus;
+	double t0, t1, clk0, clk1;
+	u_int32 c, n;
+
+	printf("\nirq cost (%u irqs each)\n", (unsigned)count);
+	printf("%-34s %8s %8s %6s %6s %6s %6s\n",
+		   "channels", "nsec", "cpuclk", "rdD8", "rdD16", "wrD8", "wrD16");
+
+	for (c=0; c<sizeof(G_chCfg)/sizeof(G_chCfg[0]); c++) {
+		SIM_DescClear();
+		SIM_DescSet("IN_BUF/SIZE", IN_BUF_SIZE);
+		SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF_OVERWR);
+		SIM_DescSet("DATA_MODE", 5);
+		DrvInit();
+		SetChannels(&G_chCfg[c]);
+
+		memset(bus, 0, sizeof(*bus));
+		t0 = NsecNow();
+		clk0 = ClkNow();
+		for (n=0; n<count; n++)
+			G_entry.irq(G_llHdl);
+		clk1 = ClkNow();
+		t1 = NsecNow();
+
+		printf("%-34s %8.1f %8.1f %6.2f %6.2f %6.2f %6.2f\n",
+			   G_chCfg[c].name, (t1 - t0) / count, (clk1 - clk0) / count,
+			   (double)bus->rdD8 / count, (double)(bus->rdD16 -
+			   bus->irqAck) / count,
+			   (double)bus->wrD8 / count, (double)bus->wrD16 / count);
+
+		DrvExit();
+	}
+	printf("(rdD16 without the CTRL3 irq reset cycle)\n");
+}
+
+/***************************** BenchBlockRead *******************************
+ *
+ *  Description: Measure direct M58_BlockRead cost per frame
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: count      nr of block reads per configuration
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void BenchBlockRead(u_int32 count)
+{
+	SIM_BUS *bus = &SIM_Bus;
+	u_int8 buf[4];
+	double t0, t1;
+	u_int32 c, n;
+	int32 nbr;
+
+	printf("\ndirect block read (%u frames each)\n", (unsigned)count);
+	printf("%-34s %8s %6s %6s\n", "channels", "nsec", "rdD8", "rdD16");
+
+	for (c=0; c<sizeof(G_chCfg)/sizeof(G_chCfg[0]); c++) {
+		SIM_DescClear();
+		DrvInit();
+		SetChannels(&G_chCfg[c]);
+
+		memset(bus, 0, sizeof(*bus));
+		t0 = NsecNow();
+		for (n=0; n<count; n++)
+			G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr);
+		t1 = NsecNow();
+
+		printf("%-34s %8.1f %6.2f %6.2f\n", G_chCfg[c].name,
+			   (t1 - t0) / count,
+			   (double)bus->rdD8 / count, (double)bus->rdD16 / count);
+
+		DrvExit();
+	}
+}
+
+/****************************** BenchOverrun ********************************
+ *
+ *  Description: Measure input buffer overruns
+ *
+ *               One second of triggers at several rates, all channels
+ *               buffered (4 byte frames). A reader takes up to RD_SIZE
+ *               bytes every RD_PERIOD usec.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void BenchOverrun(void)
+{
+	static const u_int32 rate[] = { 1000, 5000, 10000, 50000 };
+	u_int8 buf[RD_SIZE];
+	SIM_TRIGGEN gen;
+	u_int32 r, slot, frames;
+	int32 nbr;
+
+	printf("\noverrun (1 sec, %u byte buffer, read %u bytes every "
+		   "%u usec)\n", IN_BUF_SIZE, RD_SIZE, RD_PERIOD);
+	printf("%8s %8s %8s %8s\n", "rate", "frames", "read", "lost");
+
+	for (r=0; r<sizeof(rate)/sizeof(rate[0]); r++) {
+		SIM_DescClear();
+		SIM_DescSet("IN_BUF/SIZE", IN_BUF_SIZE);
+		SIM_DescSet("IN_BUF/MODE", M_BUF_RINGBUF);
+		SIM_DescSet("DATA_MODE", 5);
+		DrvInit();
+		CHECK(SetStat(0, M_MK_IRQ_ENABLE, 1) == 0);
+
+		frames = 0;
+		for (slot=0; slot<1000000/RD_PERIOD; slot++) {
+			memset(&gen, 0, sizeof(gen));
+			gen.rate = rate[r];
+			gen.count = rate[r] / (1000000 / RD_PERIOD);
+			gen.pattern = PatternCount;
+			SIM_Trigger(&G_entry, G_llHdl, &gen);
+
+			G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr);
+			frames += nbr / 4;
+		}
+
+		/* drain */
+		do {
+			G_entry.blockRead(G_llHdl, 0, buf, sizeof(buf), &nbr);
+			frames += nbr / 4;
+		} while (nbr);
+
+		printf("%8u %8u %8u %8u\n", (unsigned)rate[r], (unsigned)rate[r],
+			   (unsigned)frames, (unsigned)(rate[r] - frames));
+
+		DrvExit();
+	}
+}
@@ -0,0 +1,99 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: sim.h
+ *
+ *  Description: Host simulator of the M58 hardware and the MDIS libraries
+ *
+ *               The simulator replaces the MACCESS macros, m_read() and the
+ *               OSS, DESC and MBUF libraries (see MEN/ stand-in headers),
+ *               so that the unmodified m58_drv.c can be linked into a host
+ *               program.
+ *
+ *               The register model knows the ports A..D, the control
+ *               registers CTRL0..3 and the id prom. Time is virtual: it
+ *               only advances via SIM_Advance(), which also fires due OSS
+ *               alarms. The trigger generator calls the M58_Irq entry at
+ *               a given trigger rate, as long as the interrupt is enabled.
+ *
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _SIM_H
+#define _SIM_H
+
+#include <MEN/men_typs.h>
+#include <MEN/maccess.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include <MEN/ll_defs.h>
+#include <MEN/ll_entry.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define SIM_TICK_RATE	1000		/* OSS ticks per second */
+#define SIM_DESC_MAX	64			/* max. nr of descriptor keys */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+/* bus cycle counters of the register model */
+typedef struct {
+	u_int32	rdD8;			/* D8 read cycles */
+	u_int32	rdD16;			/* D16 read cycles */
+	u_int32	wrD8;			/* D8 write cycles */
+	u_int32	wrD16;			/* D16 write cycles */
+	u_int32	irqAck;			/* CTRL3 reads (irq reset) */
+} SIM_BUS;
+
+/* trigger generator */
+typedef struct {
+	u_int32	rate;			/* trigger rate [Hz] */
+	u_int32	count;			/* nr of triggers to generate */
+	void	(*pattern)(u_int32 n, u_int8 *pin);
+							/* sets input pins for trigger n (or NULL) */
+	u_int32	irqCalled;		/* (out) nr of M58_Irq calls */
+	u_int32	irqMasked;		/* (out) triggers lost, irq disabled */
+} SIM_TRIGGEN;
+
+/*--------------------------------------+
+|   EXTERNALS                           |
++--------------------------------------*/
+/* register model (sim_hw.c) */
+extern u_int8	SIM_Pin[4];			/* external input level port A..D */
+extern u_int8	SIM_Latch[4];		/* output latch port A..D */
+extern u_int16	SIM_Ctrl[4];		/* CTRL0..3 */
+extern u_int16	SIM_IdProm[64];		/* id prom words */
+extern SIM_BUS	SIM_Bus;			/* bus cycle counters */
+
+/* oss (sim_oss.c) */
+extern u_int32	SIM_Usec;			/* virtual time [usec] */
+extern u_int32	SIM_DelayUs;		/* sum of OSS_MikroDelay() [usec] */
+extern u_int32	SIM_DelayInit;		/* nr of OSS_MikroDelayInit() calls */
+extern u_int32	SIM_SigSent;		/* nr of OSS_SigSend() calls */
+extern void		(*SIM_WaitHook)(void);
+									/* called by OSS_SemWait() if blocking */
+
+/* buffers (sim_mbuf.c) */
+extern u_int32	SIM_BufOverrun;		/* input buffer overruns */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+/* register model (sim_hw.c) */
+extern void SIM_HwReset(void);
+extern u_int8 SIM_PortOut(int32 ch);
+extern void SIM_Trigger(LL_ENTRY *entry, LL_HANDLE *llHdl,
+						SIM_TRIGGEN *gen);
+
+/* oss (sim_oss.c) */
+extern void SIM_Advance(u_int32 usec);
+
+/* descriptor (sim_desc.c) */
+extern void SIM_DescSet(const char *key, u_int32 value);
+extern void SIM_DescClear(void);
+
+#endif /* _SIM_H */
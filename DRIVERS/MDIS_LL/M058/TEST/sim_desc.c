@@ -0,0 +1,138 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: sim_desc.c
+ *
+ *  Description: DESC stand-in (host simulator)
+ *
+ *               The descriptor is a key/value table set up by the harness
+ *               (see SIM_DescSet). Keys not in the table return their
+ *               default and ERR_DESC_KEY_NOTFOUND.
+ *
+ *     Required: -
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "sim.h"
+#include <MEN/mdis_err.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define KEY_LEN		40		/* max. key length */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+struct DESC_HANDLE {
+	int32	dummy;
+};
+
+typedef struct {
+	char	key[KEY_LEN];	/* key name (empty = unused) */
+	u_int32	value;			/* key value */
+} DESC_KEY;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static DESC_KEY G_key[SIM_DESC_MAX];
+static DESC_HANDLE G_descHdl;
+
+char *DESC_Ident(void) { return("DESC (host simulator)"); }
+
+/****************************** SIM_DescSet *********************************
+ *
+ *  Description: Add or change a descriptor key
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: key        key name (e.g. "CHANNEL_0/BUF_ENABLE")
+ *               value      key value
+ *  Output.....: -
+ *  Globals....: G_key
+ ****************************************************************************/
+void SIM_DescSet(const char *key, u_int32 value)
+{
+	int n, freeIdx = -1;
+
+	for (n=0; n<SIM_DESC_MAX; n++) {
+		if (!strcmp(G_key[n].key, key)) {
+			G_key[n].value = value;
+			return;
+		}
+		if (freeIdx < 0 && G_key[n].key[0] == '\0')
+			freeIdx = n;
+	}
+
+	if (freeIdx >= 0) {
+		strncpy(G_key[freeIdx].key, key, KEY_LEN - 1);
+		G_key[freeIdx].value = value;
+	}
+}
+
+/***************************** SIM_DescClear ********************************
+ *
+ *  Description: Remove all descriptor keys
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_key
+ ****************************************************************************/
+void SIM_DescClear(void)
+{
+	memset(G_key, 0, sizeof(G_key));
+}
+
+int32 DESC_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+				DESC_HANDLE **descHandleP)
+{
+	*descHandleP = &G_descHdl;
+	return(0);
+}
+
+int32 DESC_Exit(DESC_HANDLE **descHandleP)
+{
+	*descHandleP = NULL;
+	return(0);
+}
+
+int32 DESC_DbgLevelSet(DESC_HANDLE *descHandle, u_int32 dbgLevel)
+{
+	return(0);
+}
+
+int32 DESC_GetUInt32(DESC_HANDLE *descHandle, u_int32 defVal,
+					 u_int32 *valueP, char *keyFmt, ...)
+{
+	char key[KEY_LEN];
+	va_list argptr;
+	int n;
+
+	va_start(argptr, keyFmt);
+	vsnprintf(key, sizeof(key), keyFmt, argptr);
+	va_end(argptr);
+
+	for (n=0; n<SIM_DESC_MAX; n++) {
+		if (!strcmp(G_key[n].key, key)) {
+			*valueP = G_key[n].value;
+			return(0);
+		}
+	}
+
+	*valueP = defVal;
+	return(ERR_DESC_KEY_NOTFOUND);
+}
+
+int32 DESC_GetBinary(DESC_HANDLE *descHandle, u_int8 *defVal,
+					 u_int32 defLen, u_int8 *bufP, u_int32 *lenP,
+					 char *keyFmt, ...)
+{
+	return(ERR_DESC_KEY_NOTFOUND);
+}
@@ -0,0 +1,264 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: sim_hw.c
+ *
+ *  Description: M58 register model and trigger generator (host simulator)
+ *
+ *               The port byte offsets follow the driver's mapping, so this
+ *               file must be built with the same _BIG_ENDIAN_/
+ *               _LITTLE_ENDIAN_/MAC_BYTESWAP switches as m58_drv.c.
+ *
+ *               Not modelled: termination, trigger edge and data storage
+ *               mode (ports always show the current pin level).
+ *
+ *     Required: -
+ *     Switches: _BIG_ENDIAN_, _LITTLE_ENDIAN_, MAC_BYTESWAP
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "sim.h"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define PORT_A		0
+#define PORT_B		1
+#define PORT_C		2
+#define PORT_D		3
+
+#define CTRL0_REG	0x80		/* control 0 (direction) */
+#define CTRL3_REG	0x86		/* control 3 (irq) */
+#define IEN			0x08		/* CTRL3: irq enable */
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+u_int8	SIM_Pin[4];
+u_int8	SIM_Latch[4];
+u_int16	SIM_Ctrl[4];
+u_int16	SIM_IdProm[64];
+SIM_BUS	SIM_Bus;
+
+/* D8 offset 0x00..0x03 => port (see m58_drv.c PORTx_REG) */
+#if ( defined(_BIG_ENDIAN_) && !defined(MAC_BYTESWAP) ) ||	\
+	( defined(_LITTLE_ENDIAN_) && defined(MAC_BYTESWAP) )
+static const int G_byteToPort[4] = { PORT_D, PORT_C, PORT_B, PORT_A };
+#else
+static const int G_byteToPort[4] = { PORT_C, PORT_D, PORT_A, PORT_B };
+#endif
+
+/****************************** SIM_HwReset *********************************
+ *
+ *  Description: Reset the register model
+ *
+ *               All ports are inputs with level 0, the id prom holds the
+ *               M58 magic and module id. The bus counters are cleared.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: SIM_Pin, SIM_Latch, SIM_Ctrl, SIM_IdProm, SIM_Bus
+ ****************************************************************************/
+void SIM_HwReset(void)
+{
+	memset(SIM_Pin, 0, sizeof(SIM_Pin));
+	memset(SIM_Latch, 0, sizeof(SIM_Latch));
+	memset(SIM_IdProm, 0, sizeof(SIM_IdProm));
+	memset(&SIM_Bus, 0, sizeof(SIM_Bus));
+
+	SIM_Ctrl[0] = 0x0f;		/* all inputs */
+	SIM_Ctrl[1] = 0x0f;		/* all passive */
+	SIM_Ctrl[2] = 0x00;
+	SIM_Ctrl[3] = 0x00;		/* irq disabled */
+
+	SIM_IdProm[0] = 0x5346;	/* magic */
+	SIM_IdProm[1] = 58;		/* module id */
+}
+
+/****************************** SIM_PortOut *********************************
+ *
+ *  Description: Get the level of an output port
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ch         port (0..3 = A..D)
+ *  Output.....: return     output latch, or 0 if the port is an input
+ *  Globals....: SIM_Latch, SIM_Ctrl
+ ****************************************************************************/
+u_int8 SIM_PortOut(int32 ch)
+{
+	return( (SIM_Ctrl[0] & (1 << ch)) ? 0 : SIM_Latch[ch] );
+}
+
+/****************************** PortRead ************************************
+ *
+ *  Description: Read a port (pin level if input, latch if output)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ch         port (0..3 = A..D)
+ *  Output.....: return     port value
+ *  Globals....: SIM_Pin, SIM_Latch, SIM_Ctrl
+ ****************************************************************************/
+static u_int8 PortRead(int ch)
+{
+	return( (SIM_Ctrl[0] & (1 << ch)) ? SIM_Pin[ch] : SIM_Latch[ch] );
+}
+
+/******************************* SIM_ReadD8 *********************************
+ *
+ *  Description: MREAD_D8 of the register model
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma         access handle (unused)
+ *               offs       register offset
+ *  Output.....: return     register value
+ *  Globals....: SIM_Bus
+ ****************************************************************************/
+u_int8 SIM_ReadD8(MACCESS ma, u_int32 offs)
+{
+	SIM_Bus.rdD8++;
+
+	if (offs < 4)
+		return( PortRead(G_byteToPort[offs]) );
+
+	return(0xff);
+}
+
+/******************************* SIM_ReadD16 ********************************
+ *
+ *  Description: MREAD_D16 of the register model
+ *
+ *               Offset 0x00 returns port C/D, offset 0x02 port A/B (low
+ *               byte = port A/C). Reading CTRL3 resets the interrupt.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma         access handle (unused)
+ *               offs       register offset
+ *  Output.....: return     register value
+ *  Globals....: SIM_Bus, SIM_Ctrl
+ ****************************************************************************/
+u_int16 SIM_ReadD16(MACCESS ma, u_int32 offs)
+{
+	SIM_Bus.rdD16++;
+
+	switch (offs) {
+		case 0x00:
+			return( (u_int16)((PortRead(PORT_D) << 8) | PortRead(PORT_C)) );
+		case 0x02:
+			return( (u_int16)((PortRead(PORT_B) << 8) | PortRead(PORT_A)) );
+		case CTRL3_REG:
+			SIM_Bus.irqAck++;
+			/* fall through */
+		case 0x80: case 0x82: case 0x84:
+			return( SIM_Ctrl[(offs - CTRL0_REG) / 2] );
+	}
+
+	return(0xffff);
+}
+
+/******************************* SIM_WriteD8 ********************************
+ *
+ *  Description: MWRITE_D8 of the register model
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma         access handle (unused)
+ *               offs       register offset
+ *               val        value
+ *  Output.....: -
+ *  Globals....: SIM_Bus, SIM_Latch
+ ****************************************************************************/
+void SIM_WriteD8(MACCESS ma, u_int32 offs, u_int8 val)
+{
+	SIM_Bus.wrD8++;
+
+	if (offs < 4)
+		SIM_Latch[G_byteToPort[offs]] = val;
+}
+
+/******************************* SIM_WriteD16 *******************************
+ *
+ *  Description: MWRITE_D16 of the register model
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma         access handle (unused)
+ *               offs       register offset
+ *               val        value
+ *  Output.....: -
+ *  Globals....: SIM_Bus, SIM_Latch, SIM_Ctrl
+ ****************************************************************************/
+void SIM_WriteD16(MACCESS ma, u_int32 offs, u_int16 val)
+{
+	SIM_Bus.wrD16++;
+
+	switch (offs) {
+		case 0x00:
+			SIM_Latch[PORT_C] = (u_int8)val;
+			SIM_Latch[PORT_D] = (u_int8)(val >> 8);
+			break;
+		case 0x02:
+			SIM_Latch[PORT_A] = (u_int8)val;
+			SIM_Latch[PORT_B] = (u_int8)(val >> 8);
+			break;
+		case 0x80: case 0x82: case 0x84: case CTRL3_REG:
+			SIM_Ctrl[(offs - CTRL0_REG) / 2] = val;
+			break;
+	}
+}
+
+/********************************* m_read ***********************************
+ *
+ *  Description: Read an id prom word
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ma         access handle (unused)
+ *               index      word index
+ *  Output.....: return     id prom word
+ *  Globals....: SIM_IdProm
+ ****************************************************************************/
+int m_read(U_INT32_OR_64 ma, u_int8 index)
+{
+	return( index < 64 ? SIM_IdProm[index] : 0xffff );
+}
+
+/******************************* SIM_Trigger ********************************
+ *
+ *  Description: Trigger generator
+ *
+ *               Generates gen->count trigger edges at gen->rate. For each
+ *               trigger, the input pins are set via gen->pattern, the
+ *               virtual time is advanced (firing due alarms) and the
+ *               driver's interrupt routine is called, if the interrupt is
+ *               enabled in CTRL3. Otherwise the trigger is counted as
+ *               masked.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: entry      driver jump table
+ *               llHdl      ll handle
+ *               gen        generator parameters
+ *  Output.....: gen        irqCalled/irqMasked updated
+ *  Globals....: SIM_Pin, SIM_Ctrl
+ ****************************************************************************/
+void SIM_Trigger(LL_ENTRY *entry, LL_HANDLE *llHdl, SIM_TRIGGEN *gen)
+{
+	u_int32 n, usec, last = 0;
+
+	for (n=0; n<gen->count; n++) {
+		if (gen->pattern)
+			gen->pattern(n, SIM_Pin);
+
+		/* time of trigger n+1 (without accumulating rounding errors) */
+		usec = (u_int32)((double)(n + 1) * 1000000.0 / gen->rate);
+		SIM_Advance(usec - last);
+		last = usec;
+
+		if (SIM_Ctrl[3] & IEN) {
+			entry->irq(llHdl);
+			gen->irqCalled++;
+		}
+		else
+			gen->irqMasked++;
+	}
+}
@@ -0,0 +1,250 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: sim_mbuf.c
+ *
+ *  Description: MBUF stand-in (host simulator)
+ *
+ *               Simple byte ring per buffer. MBUF_Read/MBUF_Write never
+ *               block, they transfer what is available. A full input
+ *               buffer in M_BUF_RINGBUF or M_BUF_USRCTRL mode refuses new
+ *               blocks, in M_BUF_RINGBUF_OVERWR or M_BUF_CURRBUF mode the
+ *               oldest blocks are overwritten. Both cases are counted in
+ *               SIM_BufOverrun.
+ *
+ *     Required: -
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#include <stdlib.h>
+
+#include "sim.h"
+#include <MEN/mbuf.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+struct MBUF_HANDLE {
+	u_int8	*data;			/* ring data */
+	int32	size;			/* ring size [bytes] */
+	int32	width;			/* block width [bytes] */
+	int32	mode;			/* M_BUF_xxx */
+	int32	dir;			/* MBUF_RD/MBUF_WR */
+	int32	rdIdx;			/* read index */
+	int32	wrIdx;			/* write index */
+	int32	fill;			/* nr of bytes in ring */
+	int32	pending;		/* bytes passed by MBUF_GetNextBuf */
+};
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+u_int32 SIM_BufOverrun;
+
+char *MBUF_Ident(void) { return("MBUF (host simulator)"); }
+
+int32 MBUF_Create(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *devSem, void *lldrvHdl,
+				  int32 size, int32 width, int32 mode, int32 direction,
+				  int32 highWater, int32 timeout, OSS_IRQ_HANDLE *irqHdl,
+				  MBUF_HANDLE **bufHdlP)
+{
+	MBUF_HANDLE *buf;
+
+	if ((buf = calloc(1, sizeof(MBUF_HANDLE))) == NULL ||
+		(buf->data = malloc(size)) == NULL) {
+		free(buf);
+		return(ERR_OSS_MEM_ALLOC);
+	}
+
+	buf->size  = size;
+	buf->width = width;
+	buf->mode  = mode;
+	buf->dir   = direction;
+
+	*bufHdlP = buf;
+	return(0);
+}
+
+int32 MBUF_Remove(MBUF_HANDLE **bufHdlP)
+{
+	free((*bufHdlP)->data);
+	free(*bufHdlP);
+	*bufHdlP = NULL;
+	return(0);
+}
+
+/***************************** MBUF_GetNextBuf ******************************
+ *
+ *  Description: Get contiguous space (input buffer) or data (output
+ *               buffer) for the driver
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: bufHdl       buffer handle
+ *               nbrOfBlocks  nr of blocks wanted
+ *  Output.....: gotBlocksP   nr of contiguous blocks available
+ *               return       ptr to the blocks or NULL
+ *  Globals....: SIM_BufOverrun
+ ****************************************************************************/
+void *MBUF_GetNextBuf(MBUF_HANDLE *bufHdl, int32 nbrOfBlocks,
+					  int32 *gotBlocksP)
+{
+	int32 want = nbrOfBlocks * bufHdl->width;
+	int32 avail, toEnd;
+
+	if (bufHdl->dir == MBUF_RD) {
+		avail = bufHdl->size - bufHdl->fill;
+
+		/* buffer full */
+		if (avail == 0) {
+			SIM_BufOverrun++;
+
+			if (bufHdl->mode != M_BUF_RINGBUF_OVERWR &&
+				bufHdl->mode != M_BUF_CURRBUF)
+				return(NULL);
+
+			/* discard oldest blocks */
+			bufHdl->rdIdx = (bufHdl->rdIdx + want) % bufHdl->size;
+			bufHdl->fill -= want;
+			avail = want;
+		}
+		toEnd = bufHdl->size - bufHdl->wrIdx;
+	}
+	else {
+		if ((avail = bufHdl->fill) == 0)
+			return(NULL);
+
+		toEnd = bufHdl->size - bufHdl->rdIdx;
+	}
+
+	if (want > avail)
+		want = avail;
+	if (want > toEnd)
+		want = toEnd;
+
+	bufHdl->pending = want;
+	*gotBlocksP = want / bufHdl->width;
+
+	return( bufHdl->data +
+			(bufHdl->dir == MBUF_RD ? bufHdl->wrIdx : bufHdl->rdIdx) );
+}
+
+/****************************** MBUF_ReadyBuf *******************************
+ *
+ *  Description: Commit the blocks passed by MBUF_GetNextBuf
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: bufHdl     buffer handle
+ *  Output.....: return     0
+ *  Globals....: -
+ ****************************************************************************/
+int32 MBUF_ReadyBuf(MBUF_HANDLE *bufHdl)
+{
+	if (bufHdl->dir == MBUF_RD) {
+		bufHdl->wrIdx = (bufHdl->wrIdx + bufHdl->pending) % bufHdl->size;
+		bufHdl->fill += bufHdl->pending;
+	}
+	else {
+		bufHdl->rdIdx = (bufHdl->rdIdx + bufHdl->pending) % bufHdl->size;
+		bufHdl->fill -= bufHdl->pending;
+	}
+
+	bufHdl->pending = 0;
+	return(0);
+}
+
+int32 MBUF_EventHdlr(MBUF_HANDLE *bufHdl, int32 event)
+{
+	return(0);
+}
+
+int32 MBUF_Read(MBUF_HANDLE *bufHdl, u_int8 *buffer, int32 length,
+				int32 *nbrRdBytesP)
+{
+	int32 n = 0;
+
+	while (n < length && bufHdl->fill) {
+		buffer[n++] = bufHdl->data[bufHdl->rdIdx];
+		bufHdl->rdIdx = (bufHdl->rdIdx + 1) % bufHdl->size;
+		bufHdl->fill--;
+	}
+
+	*nbrRdBytesP = n;
+	return(0);
+}
+
+int32 MBUF_Write(MBUF_HANDLE *bufHdl, u_int8 *buffer, int32 length,
+				 int32 *nbrWrBytesP)
+{
+	int32 n = 0;
+
+	while (n < length && bufHdl->fill < bufHdl->size) {
+		bufHdl->data[bufHdl->wrIdx] = buffer[n++];
+		bufHdl->wrIdx = (bufHdl->wrIdx + 1) % bufHdl->size;
+		bufHdl->fill++;
+	}
+
+	*nbrWrBytesP = n;
+	return(0);
+}
+
+int32 MBUF_SetStat(MBUF_HANDLE *inBufHdl, MBUF_HANDLE *outBufHdl,
+				   int32 code, int32 value)
+{
+	switch (code) {
+		case M_BUF_RD_MODE:
+			if (inBufHdl)
+				inBufHdl->mode = value;
+			break;
+		case M_BUF_WR_MODE:
+			if (outBufHdl)
+				outBufHdl->mode = value;
+			break;
+		case M_BUF_RD_DEBUG_LEVEL:
+		case M_BUF_WR_DEBUG_LEVEL:
+			break;
+		default:
+			return(ERR_LL_UNK_CODE);
+	}
+
+	return(0);
+}
+
+int32 MBUF_GetStat(MBUF_HANDLE *inBufHdl, MBUF_HANDLE *outBufHdl,
+				   int32 code, int32 *valueP)
+{
+	switch (code) {
+		case M_BUF_RD_MODE:
+			*valueP = inBufHdl ? inBufHdl->mode : 0;
+			break;
+		case M_BUF_RD_COUNT:
+			*valueP = inBufHdl ? inBufHdl->fill : 0;
+			break;
+		case M_BUF_RD_BUFSIZE:
+			*valueP = inBufHdl ? inBufHdl->size : 0;
+			break;
+		case M_BUF_WR_MODE:
+			*valueP = outBufHdl ? outBufHdl->mode : 0;
+			break;
+		case M_BUF_WR_COUNT:
+			*valueP = outBufHdl ? outBufHdl->fill : 0;
+			break;
+		case M_BUF_RD_DEBUG_LEVEL:
+		case M_BUF_WR_DEBUG_LEVEL:
+			*valueP = 0;
+			break;
+		default:
+			return(ERR_LL_UNK_CODE);
+	}
+
+	return(0);
+}
+
+int32 MBUF_GetBufferMode(MBUF_HANDLE *bufHdl, int32 *valueP)
+{
+	*valueP = bufHdl->mode;
+	return(0);
+}
@@ -0,0 +1,292 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: sim_oss.c
+ *
+ *  Description: OSS stand-in (host simulator)
+ *
+ *               Single threaded: interrupt masking is a no-op, a blocking
+ *               OSS_SemWait() calls SIM_WaitHook (which may generate
+ *               triggers) once and times out if the semaphore is still
+ *               not signalled. Ticks and alarms run on the virtual time
+ *               (see SIM_Advance).
+ *
+ *     Required: -
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include <MEN/mdis_err.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define ALARM_MAX	4		/* max. nr of alarms */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+struct OSS_SEM_HANDLE {
+	int32	count;			/* semaphore count */
+};
+
+struct OSS_SIG_HANDLE {
+	int32	signal;			/* signal code */
+};
+
+struct OSS_ALARM_HANDLE {
+	void	(*funct)(void *arg);	/* alarm routine */
+	void	*arg;			/* alarm routine argument */
+	u_int32	active;			/* alarm running */
+	u_int32	cyclic;			/* cyclic alarm */
+	u_int32	period;			/* period [usec] */
+	u_int32	due;			/* next expiry [usec] */
+};
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+u_int32	SIM_Usec;
+u_int32	SIM_DelayUs;
+u_int32	SIM_DelayInit;
+u_int32	SIM_SigSent;
+void	(*SIM_WaitHook)(void);
+
+static OSS_ALARM_HANDLE *G_alarm[ALARM_MAX];
+
+char *OSS_Ident(void) { return("OSS (host simulator)"); }
+
+/*--------------------------------------+
+|   memory                              |
++--------------------------------------*/
+void *OSS_MemGet(OSS_HANDLE *osHdl, u_int32 size, u_int32 *gotsizeP)
+{
+	*gotsizeP = size;
+	return( malloc(size) );
+}
+
+int32 OSS_MemFree(OSS_HANDLE *osHdl, void *addr, u_int32 size)
+{
+	free(addr);
+	return(0);
+}
+
+void OSS_MemFill(OSS_HANDLE *osHdl, u_int32 size, char *adr, int8 value)
+{
+	memset(adr, value, size);
+}
+
+void OSS_MemCopy(OSS_HANDLE *osHdl, u_int32 size, char *src, char *dest)
+{
+	memcpy(dest, src, size);
+}
+
+/*--------------------------------------+
+|   signals                             |
++--------------------------------------*/
+int32 OSS_SigCreate(OSS_HANDLE *osHdl, int32 signal,
+					OSS_SIG_HANDLE **sigHandleP)
+{
+	if ((*sigHandleP = malloc(sizeof(OSS_SIG_HANDLE))) == NULL)
+		return(ERR_OSS_MEM_ALLOC);
+
+	(*sigHandleP)->signal = signal;
+	return(0);
+}
+
+int32 OSS_SigRemove(OSS_HANDLE *osHdl, OSS_SIG_HANDLE **sigHandleP)
+{
+	free(*sigHandleP);
+	*sigHandleP = NULL;
+	return(0);
+}
+
+int32 OSS_SigSend(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle)
+{
+	SIM_SigSent++;
+	return(0);
+}
+
+int32 OSS_SigInfo(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle,
+				  int32 *signalNbrP, int32 *processIdP)
+{
+	*signalNbrP = sigHandle->signal;
+	*processIdP = 0;
+	return(0);
+}
+
+/*--------------------------------------+
+|   semaphores                          |
++--------------------------------------*/
+int32 OSS_SemCreate(OSS_HANDLE *osHdl, int32 semType, int32 initVal,
+					OSS_SEM_HANDLE **semHandleP)
+{
+	if ((*semHandleP = malloc(sizeof(OSS_SEM_HANDLE))) == NULL)
+		return(ERR_OSS_MEM_ALLOC);
+
+	(*semHandleP)->count = initVal;
+	return(0);
+}
+
+int32 OSS_SemRemove(OSS_HANDLE *osHdl, OSS_SEM_HANDLE **semHandleP)
+{
+	free(*semHandleP);
+	*semHandleP = NULL;
+	return(0);
+}
+
+int32 OSS_SemWait(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle, int32 msec)
+{
+	/* would block: let the harness run the "other side" */
+	if (semHandle->count == 0 && msec != OSS_SEM_NOWAIT && SIM_WaitHook)
+		SIM_WaitHook();
+
+	if (semHandle->count == 0)
+		return(ERR_OSS_TIMEOUT);
+
+	semHandle->count--;
+	return(0);
+}
+
+int32 OSS_SemSignal(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle)
+{
+	semHandle->count++;
+	return(0);
+}
+
+/*--------------------------------------+
+|   time                                |
++--------------------------------------*/
+int32 OSS_MikroDelayInit(OSS_HANDLE *osHdl)
+{
+	SIM_DelayInit++;
+	return(0);
+}
+
+int32 OSS_MikroDelay(OSS_HANDLE *osHdl, u_int32 usec)
+{
+	SIM_DelayUs += usec;
+	return(0);
+}
+
+int32 OSS_Delay(OSS_HANDLE *osHdl, int32 msec)
+{
+	SIM_Advance(msec * 1000);
+	return(msec);
+}
+
+int32 OSS_TickRateGet(OSS_HANDLE *osHdl)
+{
+	return(SIM_TICK_RATE);
+}
+
+u_int32 OSS_TickGet(OSS_HANDLE *osHdl)
+{
+	return( SIM_Usec / (1000000 / SIM_TICK_RATE) );
+}
+
+/*--------------------------------------+
+|   alarms                              |
++--------------------------------------*/
+int32 OSS_AlarmCreate(OSS_HANDLE *osHdl, void (*funct)(void *arg),
+					  void *arg, OSS_ALARM_HANDLE **alarmP)
+{
+	int n;
+
+	for (n=0; n<ALARM_MAX; n++)
+		if (G_alarm[n] == NULL)
+			break;
+
+	if (n == ALARM_MAX ||
+		(G_alarm[n] = calloc(1, sizeof(OSS_ALARM_HANDLE))) == NULL)
+		return(ERR_OSS_MEM_ALLOC);
+
+	G_alarm[n]->funct = funct;
+	G_alarm[n]->arg   = arg;
+	*alarmP = G_alarm[n];
+	return(0);
+}
+
+int32 OSS_AlarmRemove(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE **alarmP)
+{
+	int n;
+
+	for (n=0; n<ALARM_MAX; n++)
+		if (G_alarm[n] == *alarmP)
+			G_alarm[n] = NULL;
+
+	free(*alarmP);
+	*alarmP = NULL;
+	return(0);
+}
+
+int32 OSS_AlarmSet(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm,
+				   u_int32 msec, u_int32 cyclic, u_int32 *realMsecP)
+{
+	alarm->active = TRUE;
+	alarm->cyclic = cyclic;
+	alarm->period = msec * 1000;
+	alarm->due    = SIM_Usec + alarm->period;
+	*realMsecP = msec;
+	return(0);
+}
+
+int32 OSS_AlarmClear(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm)
+{
+	if (!alarm->active)
+		return(ERR_OSS_BUSY_RESOURCE);
+
+	alarm->active = FALSE;
+	return(0);
+}
+
+/****************************** SIM_Advance *********************************
+ *
+ *  Description: Advance the virtual time and fire due alarms
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: usec       time step [usec]
+ *  Output.....: -
+ *  Globals....: SIM_Usec
+ ****************************************************************************/
+void SIM_Advance(u_int32 usec)
+{
+	u_int32 end = SIM_Usec + usec;
+	OSS_ALARM_HANDLE *alarm;
+	int n;
+
+	for (n=0; n<ALARM_MAX; n++) {
+		/* alarm may be removed by its own routine: re-check per expiry */
+		while ((alarm = G_alarm[n]) != NULL && alarm->active &&
+			   (int32)(end - alarm->due) >= 0) {
+			SIM_Usec = alarm->due;
+
+			if (alarm->cyclic && alarm->period)
+				alarm->due += alarm->period;
+			else
+				alarm->active = FALSE;
+
+			alarm->funct(alarm->arg);
+		}
+	}
+
+	SIM_Usec = end;
+}
+
+/*--------------------------------------+
+|   interrupt masking                   |
++--------------------------------------*/
+OSS_IRQ_STATE OSS_IrqMaskR(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHdl)
+{
+	return(0);
+}
+
+void OSS_IrqRestore(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHdl,
+					OSS_IRQ_STATE oldState)
+{
+}
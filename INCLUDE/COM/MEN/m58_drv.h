@@ -39,7 +39,77 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
-/* none */
+/* timestamped input buffer record (M58_BUF_TSTAMP) */
+typedef struct {
+	u_int32	tick;		/* OSS tick at irq entry */
+	u_int32	seq;		/* trigger sequence number */
+	u_int8	data[4];	/* enabled input channels (ascending order) */
+} M58_TS_REC;
+
+/* edge event record (M58_EVT_MASK) */
+typedef struct {
+	u_int32	tick;		/* OSS tick at irq entry */
+	u_int32	seq;		/* trigger sequence number */
+	u_int8	bit;		/* input bit 0..31 */
+	u_int8	edge;		/* M58_EDGE_FALL/M58_EDGE_RISE */
+	u_int8	res[2];		/* reserved (zero) */
+} M58_EVT_REC;
+
+/* pulse counters (M58_BLK_COUNTERS) */
+typedef struct {
+	u_int32	count[32];	/* edge count of input bit 0..31 */
+} M58_COUNTERS;
+
+/* wait for triggers (M58_BLK_WAIT_TRIG) */
+typedef struct {
+	u_int32	count;		/* in : triggers to wait for */
+	u_int32	fill;		/* in : input buffer fill level [bytes] */
+	u_int32	tout;		/* in : timeout [msec] (0 = no timeout) */
+	u_int32	trigCount;	/* out: triggers seen */
+	u_int32	elapsed;	/* out: time waited [msec] */
+} M58_WAIT;
+
+/* pattern match table entry (M58_BLK_MATCH) */
+typedef struct {
+	u_int32	mask;		/* input bits to compare */
+	u_int32	value;		/* expected value of masked bits */
+} M58_MATCH;
+
+#define M58_MATCH_MAX		8		/* max. nr of match table entries */
+
+/* reflex rule (M58_BLK_REFLEX) */
+typedef struct {
+	u_int32	mask;		/* condition: input bits to compare */
+	u_int32	value;		/* condition: expected value of masked bits */
+	u_int8	port;		/* output channel 0..3 */
+	u_int8	action;		/* M58_RFL_xxx (optionally | M58_RFL_EDGE) */
+	u_int8	data;		/* bits to set/clear/toggle, value to write */
+	u_int8	res;		/* reserved (zero) */
+} M58_REFLEX;
+
+#define M58_RFL_MAX			16		/* max. nr of reflex rules */
+
+/* command list entry (M58_BLK_CMDLIST) */
+typedef struct {
+	u_int8	op;			/* in : M58_CMD_xxx */
+	u_int8	ch;			/* in : channel 0..3 */
+	u_int8	res[2];		/* reserved (zero) */
+	u_int32	arg;		/* in : value, bits, delay or timeout */
+	u_int32	result;		/* out: value read/written, triggers seen */
+} M58_CMD;
+
+/* statistics (M58_BLK_STATS) */
+typedef struct {
+	u_int32	trigCount;	/* triggers seen */
+	u_int32	stored;		/* records stored into input buffer */
+	u_int32	dropped;	/* records dropped (input buffer overrun) */
+	u_int32	partial;	/* records stored incompletely */
+	u_int32	sigSent;	/* trigger signals sent */
+	u_int32	fillMax;	/* max. input buffer fill level [bytes] */
+	u_int32	modPoll;	/* switches to polled mode (irq moderation) */
+	u_int32	busD8;		/* port D8 bus cycles issued */
+	u_int32	busD16;		/* port D16 bus cycles issued */
+} M58_STATS;
 
 /*-----------------------------------------+
 |  DEFINES                                 |
@@ -53,6 +123,59 @@
 #define M58_BUF_ENABLE		M_DEV_OF+0x05	/* S,G: channel buffering enable */
 #define M58_BUF_RDSIZE		M_DEV_OF+0x06	/*   G: nr of enabled input  channels */
 #define M58_BUF_WRSIZE		M_DEV_OF+0x07	/*   G: nr of enabled output channels */
+#define M58_BUF_RDCYCLES	M_DEV_OF+0x08	/*   G: bus cycles per input  frame */
+#define M58_BUF_WRCYCLES	M_DEV_OF+0x09	/*   G: bus cycles per output frame */
+#define M58_RD_SAMPLES		M_DEV_OF+0x0a	/* S,G: direct input frames per read */
+#define M58_RD_PACE			M_DEV_OF+0x0b	/* S,G: direct input period [usec] */
+#define M58_WR_PLAYBACK		M_DEV_OF+0x0c	/* S,G: block write playback mode */
+#define M58_WR_PACE			M_DEV_OF+0x0d	/* S,G: timed playback period [usec] */
+#define M58_WR_TIMEOUT		M_DEV_OF+0x0e	/* S,G: triggered playback timeout [msec] */
+#define M58_BUF_TSTAMP		M_DEV_OF+0x0f	/* S,G: timestamped input records */
+#define M58_BUF_RECSIZE		M_DEV_OF+0x10	/*   G: input buffer record size */
+#define M58_STATS_CLR		M_DEV_OF+0x11	/* S  : clear statistics */
+#define M58_BUF_CAPTURE		M_DEV_OF+0x12	/* S,G: input buffer capture mode */
+#define M58_CAPT_MASK		M_DEV_OF+0x13	/* S,G: change detection mask */
+#define M58_EVT_MASK		M_DEV_OF+0x14	/* S,G: edge event mask */
+#define M58_RD_SOURCE		M_DEV_OF+0x15	/* S,G: block read source */
+#define M58_EVT_LOST		M_DEV_OF+0x16	/*   G: nr of lost edge events */
+#define M58_DEBOUNCE		M_DEV_OF+0x17	/* S,G: channel debounce count */
+#define M58_DEBOUNCE_MASK	M_DEV_OF+0x18	/* S,G: channel debounce mask */
+#define M58_CNT_RISE		M_DEV_OF+0x19	/* S,G: rising  edge counter mask */
+#define M58_CNT_FALL		M_DEV_OF+0x1a	/* S,G: falling edge counter mask */
+#define M58_CNT_CLR			M_DEV_OF+0x1b	/* S  : clear pulse counters */
+#define M58_SMP_PERIOD		M_DEV_OF+0x1c	/* S,G: periodic sampling [msec] */
+#define M58_SMP_MISSED		M_DEV_OF+0x1d	/*   G: missed sample periods */
+#define M58_MOD_THRESH		M_DEV_OF+0x1e	/* S,G: irq moderation threshold */
+#define M58_MOD_PERIOD		M_DEV_OF+0x1f	/* S,G: irq moderation poll period [msec] */
+#define M58_MOD_HOLD		M_DEV_OF+0x20	/* S,G: irq moderation hold [poll periods] */
+#define M58_MOD_POLLED		M_DEV_OF+0x21	/*   G: polled mode active */
+#define M58_SIG_EVERY		M_DEV_OF+0x22	/* S,G: signal every n triggers */
+#define M58_SIG_MINTIME		M_DEV_OF+0x23	/* S,G: min. signal interval [usec] */
+#define M58_SIG_FILL		M_DEV_OF+0x24	/* S,G: signal input buffer fill threshold */
+#define M58_SIG_PENDING		M_DEV_OF+0x25	/*   G: triggers since last signal */
+#define M58_WIN_PRE			M_DEV_OF+0x26	/* S,G: capture window pre-trigger records */
+#define M58_WIN_POST		M_DEV_OF+0x27	/* S,G: capture window post-trigger records */
+#define M58_WIN_MASK		M_DEV_OF+0x28	/* S,G: capture window arm condition mask */
+#define M58_WIN_VALUE		M_DEV_OF+0x29	/* S,G: capture window arm condition value */
+#define M58_WIN_ARM			M_DEV_OF+0x2a	/* S,G: arm capture window / window state */
+#define M58_WIN_DEPTH		M_DEV_OF+0x2b	/*   G: capture window history [records] */
+#define M58_MATCH_MODE		M_DEV_OF+0x2c	/* S,G: pattern match actions */
+#define M58_MATCH_HITS		M_DEV_OF+0x2d	/*   G: pattern match hits */
+#define M58_OUT_SET_MASK	M_DEV_OF+0x2e	/* S  : set output bits */
+#define M58_OUT_CLR_MASK	M_DEV_OF+0x2f	/* S  : clear output bits */
+#define M58_OUT_TOGGLE_MASK	M_DEV_OF+0x30	/* S  : toggle output bits */
+#define M58_PORTS_ALL		M_DEV_OF+0x31	/* S,G: all channels (port A..D) */
+#define M58_ID_REFRESH		M_DEV_OF+0x32	/* S  : re-read id prom into cache */
+
+/* M58 specific status codes (BLK) */      /* S,G: S=setstat, G=getstat */
+#define M58_BLK_STATS		M_DEV_BLK_OF+0x00	/*   G: statistics (M58_STATS) */
+#define M58_BLK_COUNTERS	M_DEV_BLK_OF+0x01	/*   G: pulse counters (M58_COUNTERS) */
+#define M58_BLK_COUNTERS_CLR M_DEV_BLK_OF+0x02	/*   G: read and clear pulse counters */
+#define M58_BLK_WAIT_TRIG	M_DEV_BLK_OF+0x03	/*   G: wait for triggers (M58_WAIT) */
+#define M58_BLK_MATCH		M_DEV_BLK_OF+0x04	/* S,G: pattern match table (M58_MATCH[]) */
+#define M58_BLK_REFLEX		M_DEV_BLK_OF+0x05	/* S,G: reflex rules (M58_REFLEX[]) */
+#define M58_BLK_REFLEX_HITS	M_DEV_BLK_OF+0x06	/*   G: reflex rule hits (u_int32[]) */
+#define M58_BLK_CMDLIST		M_DEV_BLK_OF+0x07	/*   G: execute command list (M58_CMD[]) */
 
 /* M58_PORT_TERM definitions */
 #define M58_TERM_ACTIVE		0x00
@@ -62,6 +185,53 @@
 #define M58_TRIG_FALL		0x00
 #define M58_TRIG_RISE		0x01
 
+/* M58_WR_PLAYBACK definitions */
+#define M58_PB_SINGLE		0x00	/* write one frame */
+#define M58_PB_TIMED		0x01	/* write all frames, timed */
+#define M58_PB_TRIG			0x02	/* write all frames, one per trigger */
+
+/* M58_BUF_CAPTURE definitions */
+#define M58_CAPT_ALL		0x00	/* store every frame */
+#define M58_CAPT_CHANGE		0x01	/* store changed frames only */
+
+/* M58_RD_SOURCE definitions */
+#define M58_SRC_FRAMES		0x00	/* input buffer */
+#define M58_SRC_EVENTS		0x01	/* event buffer */
+#define M58_SRC_WINDOW		0x02	/* capture window */
+
+/* M58_WIN_ARM state definitions */
+#define M58_WIN_IDLE		0x00	/* disarmed (or capture read) */
+#define M58_WIN_ARMED		0x01	/* armed, waiting for condition */
+#define M58_WIN_FIRED		0x02	/* fired, recording post-trigger */
+#define M58_WIN_DONE		0x03	/* capture complete */
+
+/* M58_MATCH_MODE flags */
+#define M58_MATCH_STORE		0x01	/* store frames on hit only */
+#define M58_MATCH_SIG		0x02	/* send signal on hit only */
+#define M58_MATCH_EDGE		0x04	/* hit = transition into match */
+#define M58_MATCH_ALL		0x07	/* (all flags) */
+
+/* M58_REFLEX actions */
+#define M58_RFL_SET			0x00	/* set data bits */
+#define M58_RFL_CLR			0x01	/* clear data bits */
+#define M58_RFL_XOR			0x02	/* toggle data bits */
+#define M58_RFL_WRITE		0x03	/* write data value */
+#define M58_RFL_EDGE		0x80	/* fire on transition into condition only */
+
+/* M58_CMD opcodes */
+#define M58_CMD_READ		0x00	/* read input channel */
+#define M58_CMD_WRITE		0x01	/* write output channel */
+#define M58_CMD_SETBITS		0x02	/* set bits of output channel */
+#define M58_CMD_CLRBITS		0x03	/* clear bits of output channel */
+#define M58_CMD_DELAY_US	0x04	/* delay [usec] */
+#define M58_CMD_WAIT_TRIG	0x05	/* wait for next trigger (last only) */
+
+#define M58_CMD_DELAY_MAX	10000	/* max. M58_CMD_DELAY_US delay [usec] */
+
+/* M58_EVT_REC edge definitions */
+#define M58_EDGE_FALL		0x00
+#define M58_EDGE_RISE		0x01
+
 #ifndef  M58_VARIANT
 # define M58_VARIANT M58
 #endif